@@ -0,0 +1,61 @@
+#include <dice/template-library/channel.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/**
+ * Contention benchmark for channel: n producers push elements into a single channel while n consumers drain it.
+ * Usage: benchmark_channel [n_threads = 16] [n_elems_per_producer = 1000000] [capacity = 1024]
+ */
+
+template<dice::template_library::channel_storage storage>
+void run(std::string_view name, size_t n_threads, size_t n_elems_per_producer, size_t capacity) {
+	dice::template_library::channel<size_t, storage> chan{capacity};
+	std::atomic<size_t> n_producers_running = n_threads;
+	std::atomic<size_t> checksum = 0;
+
+	auto const start = std::chrono::steady_clock::now();
+	{
+		std::vector<std::jthread> threads;
+		for (size_t ix = 0; ix < n_threads; ++ix) {
+			threads.emplace_back([&]() {
+				for (size_t x = 0; x < n_elems_per_producer; ++x) {
+					chan.push(x);
+				}
+
+				if (n_producers_running.fetch_sub(1) == 1) {
+					chan.close();
+				}
+			});
+
+			threads.emplace_back([&]() {
+				size_t local_sum = 0;
+				for (size_t const x : chan) {
+					local_sum += x;
+				}
+				checksum.fetch_add(local_sum);
+			});
+		}
+	}
+	auto const end = std::chrono::steady_clock::now();
+
+	auto const n_ops = n_threads * n_elems_per_producer;
+	auto const secs = std::chrono::duration<double>(end - start).count();
+	std::cout << name << ": " << n_ops << " elements in " << secs << "s (" << static_cast<double>(n_ops) / secs / 1e6 << " Mops/s)"
+			  << " [checksum " << checksum.load() << "]\n";
+}
+
+int main(int argc, char **argv) {
+	size_t const n_threads = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 16;
+	size_t const n_elems_per_producer = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1'000'000;
+	size_t const capacity = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1024;
+
+	std::cout << n_threads << " producers, " << n_threads << " consumers, capacity " << capacity << '\n';
+	run<dice::template_library::channel_storage::locked_queue>("locked_queue  ", n_threads, n_elems_per_producer, capacity);
+	run<dice::template_library::channel_storage::lock_free_ring>("lock_free_ring", n_threads, n_elems_per_producer, capacity);
+}
@@ -0,0 +1,68 @@
+#include <dice/template-library/channel.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/**
+ * Hand-off latency benchmark for the channel wait policies.
+ * Two threads play ping-pong over a pair of channels, every round trip is timed and p50/p99 are reported.
+ * Usage: benchmark_channel_latency [n_round_trips = 100000]
+ */
+
+template<typename Channel>
+void run(std::string_view name, size_t n_round_trips) {
+	Channel ping{1};
+	Channel pong{1};
+	std::vector<std::chrono::nanoseconds> round_trips;
+	round_trips.reserve(n_round_trips);
+
+	{
+		std::jthread echo{[&]() {
+			for (auto const x : ping) {
+				pong.push(x);
+			}
+			pong.close();
+		}};
+
+		for (size_t x = 0; x < n_round_trips; ++x) {
+			auto const start = std::chrono::steady_clock::now();
+			ping.push(x);
+			[[maybe_unused]] auto const res = pong.pop();
+			round_trips.push_back(std::chrono::steady_clock::now() - start);
+		}
+		ping.close();
+	}
+
+	std::ranges::sort(round_trips);
+	auto percentile = [&](double p) {
+		return round_trips[static_cast<size_t>(p * static_cast<double>(round_trips.size() - 1))].count();
+	};
+
+	std::cout << name << ": p50 " << percentile(0.5) << " ns, p99 " << percentile(0.99) << " ns\n";
+}
+
+template<dice::template_library::channel_storage storage>
+void run_all(std::string_view storage_name, size_t n_round_trips) {
+	using namespace dice::template_library;
+	constexpr auto instr = channel_instrumentation::disabled;
+
+	std::cout << storage_name << '\n';
+	run<channel<size_t, storage, instr, park_wait_policy>>("  park    ", n_round_trips);
+	run<channel<size_t, storage, instr, spin_wait_policy<>>>("  spin    ", n_round_trips);
+	run<channel<size_t, storage, instr, adaptive_wait_policy<>>>("  adaptive", n_round_trips);
+}
+
+int main(int argc, char **argv) {
+	size_t const n_round_trips = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100'000;
+
+	using namespace dice::template_library;
+	std::cout << "ping-pong, " << n_round_trips << " round trips\n";
+	run_all<channel_storage::locked_queue>("locked_queue", n_round_trips);
+	run_all<channel_storage::lock_free_ring>("lock_free_ring", n_round_trips);
+}
@@ -0,0 +1,72 @@
+#include <dice/template-library/exchange_channel.hpp>
+#include <dice/template-library/seqlock_exchange_channel.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/**
+ * Throughput benchmark for exchanging a small, trivially copyable value between one writer and multiple readers.
+ * Usage: benchmark_exchange_channel [n_readers = 2] [duration_ms = 1000]
+ */
+
+struct progress {
+	uint64_t n_processed;
+	uint64_t n_total;
+};
+
+template<typename Channel>
+void run(std::string_view name, size_t n_readers, std::chrono::milliseconds duration) {
+	Channel chan;
+	std::atomic<bool> stop = false;
+	std::atomic<uint64_t> n_pushed = 0;
+	std::atomic<uint64_t> n_popped = 0;
+
+	{
+		std::vector<std::jthread> threads;
+		threads.emplace_back([&]() {
+			uint64_t x = 0;
+			while (!stop.load(std::memory_order_relaxed)) {
+				chan.push(progress{x, x + 1});
+				++x;
+			}
+			n_pushed = x;
+			chan.close();
+		});
+
+		for (size_t ix = 0; ix < n_readers; ++ix) {
+			threads.emplace_back([&]() {
+				uint64_t n = 0;
+				while (!chan.closed()) {
+					if (chan.try_pop().has_value()) {
+						++n;
+					}
+				}
+				n_popped.fetch_add(n);
+			});
+		}
+
+		std::this_thread::sleep_for(duration);
+		stop = true;
+	}
+
+	auto const secs = std::chrono::duration<double>(duration).count();
+	std::cout << name << ": " << static_cast<double>(n_pushed) / secs / 1e6 << " Mpushes/s, "
+			  << static_cast<double>(n_popped) / secs / 1e6 << " Mpops/s\n";
+}
+
+int main(int argc, char **argv) {
+	size_t const n_readers = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2;
+	std::chrono::milliseconds const duration{argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000};
+
+	using namespace dice::template_library;
+	std::cout << "1 writer, " << n_readers << " readers, " << duration.count() << " ms\n";
+	run<exchange_channel<progress>>("exchange_channel        ", n_readers, duration);
+	run<seqlock_exchange_channel<progress>>("seqlock_exchange_channel", n_readers, duration);
+}
@@ -0,0 +1,57 @@
+#include <dice/template-library/mutex.hpp>
+#include <dice/template-library/spin_futex_mutex.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/**
+ * Microbenchmark for mutexes protecting very short critical sections, at increasing levels of contention (1, 2, 4, ... threads).
+ * Usage: benchmark_mutex [max_threads = 2 * hardware_concurrency] [n_ops_per_thread = 1000000]
+ */
+
+template<typename Mutex>
+void run(std::string_view name, size_t n_threads, size_t n_ops) {
+	dice::template_library::mutex<std::vector<uint64_t>, Mutex> data{std::vector<uint64_t>(8, 0)};
+
+	auto const start = std::chrono::steady_clock::now();
+	{
+		std::vector<std::jthread> threads;
+		for (size_t t = 0; t < n_threads; ++t) {
+			threads.emplace_back([&data, n_ops, t]() {
+				for (size_t op = 0; op < n_ops; ++op) {
+					auto guard = data.lock();
+					++(*guard)[(t + op) % guard->size()];
+				}
+			});
+		}
+	}
+	auto const end = std::chrono::steady_clock::now();
+
+	uint64_t checksum = 0;
+	for (auto const x : *data.lock()) {
+		checksum += x;
+	}
+
+	auto const secs = std::chrono::duration<double>(end - start).count();
+	std::cout << "  " << name << ": " << static_cast<double>(n_threads * n_ops) / secs / 1e6 << " Mops/s [checksum " << checksum << "]\n";
+}
+
+int main(int argc, char **argv) {
+	size_t const max_threads = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2 * std::max(1u, std::thread::hardware_concurrency());
+	size_t const n_ops = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1'000'000;
+
+	using namespace dice::template_library;
+	for (size_t n_threads = 1; n_threads <= max_threads; n_threads *= 2) {
+		std::cout << n_threads << " threads, " << n_ops << " ops per thread\n";
+		run<std::mutex>("std::mutex      ", n_threads, n_ops);
+		run<spin_futex_mutex>("spin_futex_mutex", n_threads, n_ops);
+	}
+}
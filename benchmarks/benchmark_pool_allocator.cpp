@@ -0,0 +1,82 @@
+#include <dice/template-library/pool_allocator.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string_view>
+#include <vector>
+
+/**
+ * Microbenchmark for allocation and deallocation throughput of pool (with 12 buckets, with and without huge pages) compared to plain new/delete,
+ * for a random mix of allocation sizes (up to slightly larger than the largest bucket) and a fixed number of live allocations.
+ * Usage: benchmark_pool_allocator [n_ops = 10000000] [n_live = 1024]
+ */
+
+using pool_type = dice::template_library::pool<8, 16, 24, 32, 48, 64, 96, 128, 256, 512, 1024, 2048>;
+
+struct new_delete {
+	void *allocate(size_t n_bytes) {
+		return ::operator new(n_bytes);
+	}
+
+	void deallocate(void *data, size_t n_bytes) {
+		::operator delete(data, n_bytes);
+	}
+};
+
+template<typename Alloc>
+void run(std::string_view name, Alloc &alloc, std::vector<size_t> const &sizes, size_t n_ops, size_t n_live) {
+	std::vector<void *> live(n_live, nullptr);
+
+	auto const start = std::chrono::steady_clock::now();
+	for (size_t op = 0; op < n_ops; ++op) {
+		auto const slot = op % n_live;
+		auto const n_bytes = sizes[op % sizes.size()];
+
+		if (live[slot] != nullptr) {
+			alloc.deallocate(live[slot], sizes[(op - n_live) % sizes.size()]);
+		}
+		live[slot] = alloc.allocate(n_bytes);
+		*static_cast<unsigned char *>(live[slot]) = static_cast<unsigned char>(op);
+	}
+	auto const end = std::chrono::steady_clock::now();
+
+	uint64_t checksum = 0;
+	for (size_t slot = 0; slot < n_live; ++slot) {
+		if (live[slot] != nullptr) {
+			checksum += *static_cast<unsigned char *>(live[slot]);
+			auto const last_op = n_ops - 1 - ((n_ops - 1 - slot) % n_live);
+			alloc.deallocate(live[slot], sizes[last_op % sizes.size()]);
+		}
+	}
+
+	auto const secs = std::chrono::duration<double>(end - start).count();
+	std::cout << "  " << name << ": " << static_cast<double>(n_ops) / secs / 1e6 << " Mops/s [checksum " << checksum << "]\n";
+}
+
+int main(int argc, char **argv) {
+	size_t const n_ops = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10'000'000;
+	size_t const n_live = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1024;
+
+	std::mt19937_64 rng{42};
+	std::uniform_int_distribution<size_t> size_dist{1, 2100};
+	std::vector<size_t> sizes(4099); // not a multiple of n_live, so that slots see different sizes
+	for (auto &size : sizes) {
+		// mostly small (node-like) allocations
+		size = size_dist(rng) % 4 == 0 ? size_dist(rng) : size_dist(rng) % 128 + 1;
+	}
+
+	std::cout << n_ops << " ops, " << n_live << " live allocations\n";
+
+	pool_type pool;
+	run("pool      ", pool, sizes, n_ops, n_live);
+
+	pool_type huge_page_pool{dice::template_library::pool_config{.initial_block_chunks = 4096, .huge_pages = true}};
+	run("pool (thp)", huge_page_pool, sizes, n_ops, n_live);
+
+	new_delete nd;
+	run("new/delete", nd, sizes, n_ops, n_live);
+}
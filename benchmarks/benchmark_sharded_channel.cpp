@@ -0,0 +1,72 @@
+#include <dice/template-library/channel.hpp>
+#include <dice/template-library/sharded_channel.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/**
+ * Consumer contention benchmark: n producers push elements that are drained by n consumers,
+ * either through a single channel or through a sharded_channel with one shard per consumer.
+ * Usage: benchmark_sharded_channel [n_threads = 16] [n_elems_per_producer = 1000000] [capacity = 1024]
+ */
+
+template<typename Channel, typename MakeConsumer>
+void run(std::string_view name, Channel &chan, size_t n_threads, size_t n_elems_per_producer, MakeConsumer make_consumer) {
+	std::atomic<size_t> n_producers_running = n_threads;
+	std::atomic<size_t> checksum = 0;
+
+	auto const start = std::chrono::steady_clock::now();
+	{
+		std::vector<std::jthread> threads;
+		for (size_t ix = 0; ix < n_threads; ++ix) {
+			threads.emplace_back([&]() {
+				for (size_t x = 0; x < n_elems_per_producer; ++x) {
+					chan.push(x);
+				}
+
+				if (n_producers_running.fetch_sub(1) == 1) {
+					chan.close();
+				}
+			});
+
+			threads.emplace_back([&, ix]() {
+				size_t local_sum = 0;
+				for (size_t const x : make_consumer(ix)) {
+					local_sum += x;
+				}
+				checksum.fetch_add(local_sum);
+			});
+		}
+	}
+	auto const end = std::chrono::steady_clock::now();
+
+	auto const n_ops = n_threads * n_elems_per_producer;
+	auto const secs = std::chrono::duration<double>(end - start).count();
+	std::cout << name << ": " << n_ops << " elements in " << secs << "s (" << static_cast<double>(n_ops) / secs / 1e6 << " Mops/s)"
+			  << " [checksum " << checksum.load() << "]\n";
+}
+
+int main(int argc, char **argv) {
+	size_t const n_threads = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 16;
+	size_t const n_elems_per_producer = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1'000'000;
+	size_t const capacity = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1024;
+
+	std::cout << n_threads << " producers, " << n_threads << " consumers, total capacity " << capacity << '\n';
+
+	{
+		dice::template_library::channel<size_t> chan{capacity};
+		run("channel        ", chan, n_threads, n_elems_per_producer, [&chan](size_t) -> auto & { return chan; });
+	}
+
+	{
+		dice::template_library::sharded_channel<size_t> chan{n_threads, std::max<size_t>(capacity / n_threads, 1)};
+		run("sharded_channel", chan, n_threads, n_elems_per_producer, [&chan](size_t ix) { return chan.consumer(ix); });
+	}
+}
@@ -0,0 +1,78 @@
+#include <dice/template-library/shared_mutex.hpp>
+#include <dice/template-library/striped_shared_mutex.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <shared_mutex>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Read-heavy benchmark for reader-writer mutexes: threads look up keys in a shared dictionary and only rarely insert.
+ * Usage: benchmark_shared_mutex [n_threads = hardware_concurrency] [n_ops_per_thread = 1000000] [writes_per_million = 1000]
+ */
+
+template<typename Mutex>
+void run(std::string_view name, size_t n_threads, size_t n_ops, size_t writes_per_million) {
+	constexpr uint64_t n_keys = 1024;
+
+	dice::template_library::shared_mutex<std::unordered_map<uint64_t, uint64_t>, Mutex> dict;
+	{
+		auto guard = dict.lock();
+		for (uint64_t key = 0; key < n_keys; ++key) {
+			(*guard)[key] = key;
+		}
+	}
+
+	std::vector<uint64_t> checksums(n_threads);
+	auto const start = std::chrono::steady_clock::now();
+	{
+		std::vector<std::jthread> threads;
+		for (size_t t = 0; t < n_threads; ++t) {
+			threads.emplace_back([&, t]() {
+				uint64_t checksum = 0;
+				uint64_t rng = t + 1;
+				for (size_t op = 0; op < n_ops; ++op) {
+					// xorshift
+					rng ^= rng << 13;
+					rng ^= rng >> 7;
+					rng ^= rng << 17;
+
+					if (rng % 1'000'000 < writes_per_million) {
+						(*dict.lock())[rng % n_keys] = rng;
+					} else {
+						auto guard = dict.lock_shared();
+						checksum += guard->find(rng % n_keys)->second;
+					}
+				}
+				checksums[t] = checksum;
+			});
+		}
+	}
+	auto const end = std::chrono::steady_clock::now();
+
+	uint64_t checksum = 0;
+	for (auto const c : checksums) {
+		checksum += c;
+	}
+
+	auto const secs = std::chrono::duration<double>(end - start).count();
+	std::cout << name << ": " << static_cast<double>(n_threads * n_ops) / secs / 1e6 << " Mops/s [checksum " << checksum << "]\n";
+}
+
+int main(int argc, char **argv) {
+	size_t const n_threads = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::max(1u, std::thread::hardware_concurrency());
+	size_t const n_ops = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1'000'000;
+	size_t const writes_per_million = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1'000;
+
+	using namespace dice::template_library;
+	std::cout << n_threads << " threads, " << n_ops << " ops per thread, " << writes_per_million << " writes per million ops\n";
+	run<std::shared_mutex>("std::shared_mutex     ", n_threads, n_ops, writes_per_million);
+	run<striped_shared_mutex<>>("striped_shared_mutex<>", n_threads, n_ops, writes_per_million);
+}
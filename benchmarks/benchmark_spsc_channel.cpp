@@ -0,0 +1,49 @@
+#include <dice/template-library/channel.hpp>
+#include <dice/template-library/spsc_channel.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <string_view>
+#include <thread>
+
+/**
+ * Throughput benchmark for a single producer feeding a single consumer.
+ * Usage: benchmark_spsc_channel [n_elems = 10000000] [capacity = 1024]
+ */
+
+template<typename Channel>
+void run(std::string_view name, size_t n_elems, size_t capacity) {
+	Channel chan{capacity};
+	size_t checksum = 0;
+
+	auto const start = std::chrono::steady_clock::now();
+	{
+		std::jthread producer{[&]() {
+			for (size_t x = 0; x < n_elems; ++x) {
+				chan.push(x);
+			}
+			chan.close();
+		}};
+
+		for (size_t const x : chan) {
+			checksum += x;
+		}
+	}
+	auto const end = std::chrono::steady_clock::now();
+
+	auto const secs = std::chrono::duration<double>(end - start).count();
+	std::cout << name << ": " << static_cast<double>(n_elems) / secs / 1e6 << " Mops/s [checksum " << checksum << "]\n";
+}
+
+int main(int argc, char **argv) {
+	size_t const n_elems = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10'000'000;
+	size_t const capacity = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1024;
+
+	using namespace dice::template_library;
+	std::cout << "1 producer, 1 consumer, " << n_elems << " elements, capacity " << capacity << '\n';
+	run<channel<size_t, channel_storage::locked_queue>>("channel (locked_queue)  ", n_elems, capacity);
+	run<channel<size_t, channel_storage::lock_free_ring>>("channel (lock_free_ring)", n_elems, capacity);
+	run<spsc_channel<size_t>>("spsc_channel            ", n_elems, capacity);
+}
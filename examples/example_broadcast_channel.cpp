@@ -0,0 +1,35 @@
+#include <dice/template-library/broadcast_channel.hpp>
+
+#include <cassert>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+using config = std::map<std::string, int>;
+
+int main() {
+	dice::template_library::broadcast_channel<config> configs;
+
+	std::vector<std::jthread> readers;
+	for (int ix = 0; ix < 3; ++ix) {
+		// every reader needs its own subscriber, each one observes every version (that is not overwritten in the meantime) once
+		readers.emplace_back([sub = configs.subscribe(), ix]() mutable {
+			for (auto const &snapshot : sub) {
+				// snapshots are immutable and reference counted, holding one never blocks the writer
+				assert(snapshot->at("threads") == static_cast<int>(snapshot.version));
+				std::cout << "reader " << ix << " sees version " << snapshot.version << '\n';
+			}
+		});
+	}
+
+	for (int version = 1; version <= 3; ++version) {
+		configs.push(config{{"threads", version}});
+	}
+	configs.close(); // don't forget to close
+
+	readers.clear();
+	std::cout << "latest version: " << configs.version() << '\n';
+}
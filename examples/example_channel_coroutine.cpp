@@ -0,0 +1,53 @@
+#include <dice/template-library/channel.hpp>
+
+#include <coroutine>
+#include <exception>
+#include <iostream>
+#include <thread>
+
+
+/**
+ * Minimal coroutine type that starts eagerly and destroys itself on completion
+ */
+struct detached_task {
+	struct promise_type {
+		detached_task get_return_object() noexcept { return {}; }
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept { return {}; }
+		void return_void() noexcept {}
+		void unhandled_exception() noexcept { std::terminate(); }
+	};
+};
+
+int main() {
+	// coroutines that are ready to continue are pushed into this channel and resumed by a single worker thread
+	dice::template_library::channel<std::coroutine_handle<>> run_queue{16};
+	auto executor = [&run_queue](std::coroutine_handle<> handle) {
+		run_queue.push(handle);
+	};
+
+	dice::template_library::channel<int> chan{2};
+
+	auto producer = [&]() -> detached_task {
+		for (int x = 0; x < 10; ++x) {
+			co_await chan.co_push(x, executor); // suspends instead of blocking if chan is full
+		}
+		chan.close(); // don't forget to close
+	};
+
+	auto consumer = [&]() -> detached_task {
+		while (auto x = co_await chan.co_pop(executor)) { // suspends instead of blocking if chan is empty
+			std::cout << *x << ' ';
+		}
+		run_queue.close();
+	};
+
+	std::jthread worker{[&run_queue]() {
+		for (auto handle : run_queue) {
+			handle.resume();
+		}
+	}};
+
+	consumer();
+	producer();
+}
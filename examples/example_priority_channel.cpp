@@ -0,0 +1,30 @@
+#include <dice/template-library/priority_channel.hpp>
+
+#include <iostream>
+#include <string>
+#include <thread>
+
+
+struct job {
+	int priority;
+	std::string name;
+
+	bool operator<(job const &other) const noexcept {
+		return priority < other.priority;
+	}
+};
+
+int main() {
+	dice::template_library::priority_channel<job> chan{8};
+
+	chan.push(job{1, "batch job 1"});
+	chan.push(job{1, "batch job 2"});
+	chan.push(job{10, "interactive query"}); // overtakes the batch jobs
+	chan.close(); // don't forget to close
+
+	std::jthread consumer{[&chan]() {
+		for (auto const &j : chan) {
+			std::cout << j.name << '\n';
+		}
+	}};
+}
@@ -0,0 +1,32 @@
+#include <dice/template-library/rcu.hpp>
+
+#include <cassert>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+int main() {
+	dice::template_library::rcu<std::map<std::string, int>> lookup_table{std::map<std::string, int>{{"a", 1}}};
+
+	std::vector<std::jthread> readers;
+	for (int ix = 0; ix < 4; ++ix) {
+		readers.emplace_back([&lookup_table]() {
+			for (int it = 0; it < 1000; ++it) {
+				// readers never wait, they see either the old or the new version of the table, never a partially updated one
+				auto table = lookup_table.read();
+				assert(table->at("a") == 1);
+				assert(table->size() == 1 || table->at("b") == 2);
+			}
+		});
+	}
+
+	// writers publish a modified copy, the old version is reclaimed once no reader uses it anymore
+	lookup_table.update([](auto &table) {
+		table["b"] = 2;
+	});
+
+	readers.clear();
+	assert(lookup_table.read()->size() == 2);
+}
@@ -0,0 +1,41 @@
+#include <dice/template-library/channel.hpp>
+#include <dice/template-library/exchange_channel.hpp>
+#include <dice/template-library/select.hpp>
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include <variant>
+
+
+int main() {
+	dice::template_library::channel<int> numbers{8};
+	dice::template_library::exchange_channel<std::string> status;
+
+	std::jthread number_producer{[&numbers]() {
+		for (int x = 0; x < 5; ++x) {
+			numbers.push(x);
+		}
+		numbers.close(); // don't forget to close
+	}};
+
+	std::jthread status_producer{[&status]() {
+		status.push("working");
+		status.push("done");
+		status.close();
+	}};
+
+	// blocks until any of the channels has an element, returns std::nullopt once all of them are closed and drained
+	while (auto elem = dice::template_library::select(numbers, status)) {
+		switch (elem->index()) {
+			case 0: {
+				std::cout << "number: " << std::get<0>(*elem) << '\n';
+				break;
+			}
+			case 1: {
+				std::cout << "status: " << std::get<1>(*elem) << '\n';
+				break;
+			}
+		}
+	}
+}
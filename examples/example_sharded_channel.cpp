@@ -0,0 +1,39 @@
+#include <dice/template-library/sharded_channel.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+
+int main() {
+	// one shard per consumer, each shard holds at most 4 elements
+	dice::template_library::sharded_channel<int> chan{2, 4};
+
+	std::vector<int> received[2];
+	{
+		std::vector<std::jthread> consumers;
+		for (size_t ix = 0; ix < 2; ++ix) {
+			consumers.emplace_back([&chan, &received, ix]() {
+				// pops from shard ix first and steals from the other shard if it is empty
+				for (int x : chan.consumer(ix)) {
+					received[ix].push_back(x);
+				}
+			});
+		}
+
+		for (int x = 0; x < 10; ++x) {
+			chan.push(x); // elements are distributed round-robin over the shards
+		}
+		chan.close(); // don't forget to close
+	}
+
+	std::vector<int> all;
+	for (auto const &r : received) {
+		all.insert(all.end(), r.begin(), r.end());
+	}
+	std::ranges::sort(all);
+	assert(std::ranges::equal(all, std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+	std::cout << "consumer 0 received " << received[0].size() << ", consumer 1 received " << received[1].size() << " elements\n";
+}
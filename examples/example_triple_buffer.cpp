@@ -0,0 +1,36 @@
+#include <dice/template-library/triple_buffer.hpp>
+
+#include <cassert>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+
+struct statistics_table {
+	int version = 0;
+	std::vector<double> rows;
+};
+
+int main() {
+	dice::template_library::triple_buffer<statistics_table> stats;
+
+	std::jthread producer{[&stats]() {
+		for (int version = 1; version <= 100; ++version) {
+			// update the back buffer in place (reusing its allocation) and publish it with a single atomic swap
+			stats.write([version](statistics_table &table) {
+				table.version = version;
+				table.rows.assign(1024, static_cast<double>(version));
+			});
+		}
+	}};
+
+	// the consumer never waits for the producer, it always sees the latest completely written table
+	int last_version = 0;
+	while (last_version < 100) {
+		auto const &table = stats.read();
+		assert(table.version >= last_version);
+		last_version = table.version;
+	}
+
+	std::cout << "latest version: " << last_version << '\n';
+}
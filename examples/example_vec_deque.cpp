@@ -0,0 +1,30 @@
+#include <dice/template-library/vec_deque.hpp>
+
+#include <cassert>
+#include <iostream>
+
+
+int main() {
+	dice::template_library::vec_deque<int> dq;
+	dq.reserve(4); // allocates once, using it as a fifo queue of at most 4 elements will never allocate again
+
+	dq.push_back(2);
+	dq.push_back(3);
+	dq.push_front(1);
+	assert(dq.front() == 1 && dq.back() == 3);
+
+	dq.pop_back();
+	dq.push_back(4); // 1 was pushed to the front, so the elements wrap around the end of the buffer
+	assert(dq.capacity() == 4);
+
+	// the elements are stored in (at most) two contiguous slices
+	auto [first, second] = dq.as_slices();
+	for (int x : first) {
+		std::cout << x << ' ';
+	}
+	std::cout << "| ";
+	for (int x : second) {
+		std::cout << x << ' ';
+	}
+	std::cout << '\n';
+}
@@ -0,0 +1,313 @@
+#ifndef DICE_TEMPLATELIBRARY_BROADCASTCHANNEL_HPP
+#define DICE_TEMPLATELIBRARY_BROADCASTCHANNEL_HPP
+
+#include <dice/template-library/channel.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace dice::template_library {
+
+    /**
+     * A version of a value published via a broadcast_channel.
+     * Snapshots are reference counted and stay valid (and unchanged) for as long as they are held, independent of newer versions.
+     *
+     * @tparam T value type
+     */
+    template<typename T>
+    struct broadcast_snapshot {
+        uint64_t version = 0; ///< sequence number of the value, the first value pushed into a channel has version 1
+        std::shared_ptr<T const> value; ///< the value
+
+        [[nodiscard]] T const &operator*() const noexcept {
+            return *value;
+        }
+
+        [[nodiscard]] T const *operator->() const noexcept {
+            return value.get();
+        }
+    };
+
+    /**
+     * A multi producer, multi consumer channel that only retains the last sent value (like exchange_channel),
+     * but every subscriber observes the latest value instead of only one consumer.
+     *
+     * Each pushed value gets a monotonically increasing version number. Subscribers (see subscribe()) remember the last version
+     * they have seen, so every subscriber sees each version at most once, but skips versions that were overwritten before it looked.
+     * Values are handed out as immutable, reference counted snapshots, so readers never copy a value
+     * and holding on to a snapshot never blocks the writer.
+     * Subscribers poll for new versions without locking, a lock is only (briefly) taken to copy the pointer to a new version.
+     *
+     * @tparam T value type of the channel
+     */
+    template<typename T>
+    struct broadcast_channel {
+        using value_type = T;
+        using snapshot_type = broadcast_snapshot<T>;
+
+    private:
+        struct node {
+            uint64_t version = 0;
+            T value;
+
+            template<typename ...Args>
+            explicit node(Args &&...args) noexcept(std::is_nothrow_constructible_v<T, decltype(std::forward<Args>(args))...>)
+                : value(std::forward<Args>(args)...) {
+            }
+        };
+
+        std::mutex writer_mutex_; ///< serializes writers, never taken by readers
+        uint64_t last_version_ = 0; ///< version of the last pushed value, protected by writer_mutex_
+        mutable std::mutex latest_mutex_; ///< mutex for latest_, only ever held to copy or replace the pointer
+        std::shared_ptr<node const> latest_; ///< the latest value, nullptr if nothing was pushed yet
+        std::atomic<uint64_t> version_ = 0; ///< version of latest_, allows subscribers to poll without touching latest_
+
+        std::atomic_flag closed_ = ATOMIC_FLAG_INIT; ///< true if this channel is closed
+        std::mutex park_mutex_; ///< mutex for has_new_version_
+        detail_channel::parking_spot has_new_version_; ///< subscribers wait for "there is a version they have not seen or the channel is closed"
+
+        [[nodiscard]] static snapshot_type make_snapshot(std::shared_ptr<node const> n) noexcept {
+            auto const version = n->version;
+            auto const *value = &n->value;
+            return snapshot_type{version, std::shared_ptr<T const>{std::move(n), value}};
+        }
+
+        [[nodiscard]] std::shared_ptr<node const> load_latest() const noexcept {
+            std::lock_guard lock{latest_mutex_};
+            return latest_;
+        }
+
+        [[nodiscard]] bool has_newer_than(uint64_t version) const noexcept {
+            return version_.load(std::memory_order_acquire) > version;
+        }
+
+        /**
+         * @return the latest snapshot, if it is newer than last_seen, updates last_seen
+         */
+        [[nodiscard]] std::optional<snapshot_type> try_pop_newer(uint64_t &last_seen) const noexcept {
+            if (!has_newer_than(last_seen)) {
+                return std::nullopt;
+            }
+
+            auto snapshot = make_snapshot(load_latest());
+            last_seen = snapshot.version;
+            return snapshot;
+        }
+
+        [[nodiscard]] std::optional<snapshot_type> pop_newer(uint64_t &last_seen) noexcept {
+            has_new_version_.park(park_mutex_, [&]() noexcept { return has_newer_than(last_seen) || closed(); });
+            return try_pop_newer(last_seen);
+        }
+
+        template<typename Clock, typename Duration>
+        [[nodiscard]] std::expected<snapshot_type, channel_error> pop_newer_until(uint64_t &last_seen, std::chrono::time_point<Clock, Duration> const &deadline) noexcept {
+            if (!has_new_version_.park_until(park_mutex_, deadline, [&]() noexcept { return has_newer_than(last_seen) || closed(); })) {
+                return std::unexpected{channel_error::timeout};
+            }
+
+            if (auto snapshot = try_pop_newer(last_seen); snapshot.has_value()) {
+                return std::move(*snapshot);
+            }
+            return std::unexpected{channel_error::closed};
+        }
+
+    public:
+        /**
+         * A subscription to a broadcast_channel, remembers the last version that was seen through it.
+         * Each thread that wants to observe all new versions needs its own subscriber.
+         *
+         * @warning A subscriber must not be used by multiple threads at the same time.
+         */
+        struct subscriber {
+            using value_type = snapshot_type;
+            using pointer = snapshot_type *;
+            using const_pointer = snapshot_type const *;
+
+        private:
+            broadcast_channel *chan_;
+            uint64_t last_seen_ = 0; ///< version of the last snapshot that was popped via this subscriber
+
+        public:
+            explicit subscriber(broadcast_channel &chan) noexcept : chan_{&chan} {
+            }
+
+            /**
+             * @return the version of the last snapshot popped via this subscriber, 0 if there was none
+             */
+            [[nodiscard]] uint64_t last_seen_version() const noexcept {
+                return last_seen_;
+            }
+
+            /**
+             * Get the latest value if this subscriber has not seen it yet. Does not block.
+             * @return the latest snapshot, or std::nullopt if there is no version newer than the last one seen by this subscriber
+             */
+            [[nodiscard]] std::optional<snapshot_type> try_pop() noexcept {
+                return chan_->try_pop_newer(last_seen_);
+            }
+
+            /**
+             * Wait until there is a version that this subscriber has not seen yet and get it.
+             * @return the latest snapshot, or std::nullopt if the channel was closed and this subscriber has seen the latest version
+             */
+            [[nodiscard]] std::optional<snapshot_type> pop() noexcept {
+                return chan_->pop_newer(last_seen_);
+            }
+
+            /**
+             * Like pop(), but give up once deadline has passed.
+             * @return the latest snapshot, or channel_error::closed if the channel was closed and this subscriber has seen the latest version,
+             *         or channel_error::timeout if there was no new version before the deadline
+             */
+            template<typename Clock, typename Duration>
+            [[nodiscard]] std::expected<snapshot_type, channel_error> pop_until(std::chrono::time_point<Clock, Duration> const &deadline) noexcept {
+                return chan_->pop_newer_until(last_seen_, deadline);
+            }
+
+            /**
+             * Like pop(), but give up after timeout.
+             * @see pop_until
+             */
+            template<typename Rep, typename Period>
+            [[nodiscard]] std::expected<snapshot_type, channel_error> pop_for(std::chrono::duration<Rep, Period> const &timeout) noexcept {
+                return pop_until(std::chrono::steady_clock::now() + timeout);
+            }
+
+            using iterator = detail_channel::channel_iterator<subscriber>;
+            using sentinel = std::default_sentinel_t;
+
+            /**
+             * @return an iterator over all future versions of the channel (that are not overwritten before this subscriber sees them)
+             * @note iterator == end() is true once the channel is closed and this subscriber has seen the latest version
+             */
+            [[nodiscard]] iterator begin() noexcept {
+                return iterator{this};
+            }
+
+            [[nodiscard]] sentinel end() const noexcept {
+                return std::default_sentinel;
+            }
+        };
+
+        broadcast_channel() noexcept = default;
+
+        // there is no way to safely implement these with concurrent access
+        broadcast_channel(broadcast_channel const &other) = delete;
+        broadcast_channel(broadcast_channel &&other) = delete;
+        broadcast_channel &operator=(broadcast_channel const &other) = delete;
+        broadcast_channel &operator=(broadcast_channel &&other) noexcept = delete;
+
+        ~broadcast_channel() noexcept = default;
+
+        /**
+         * Closes the channel.
+         * Subscribers can still get the latest value if they have not seen it yet.
+         */
+        void close() noexcept {
+            {
+                // no value can be published after close() returned
+                std::lock_guard lock{writer_mutex_};
+                closed_.test_and_set(std::memory_order_release);
+            }
+            has_new_version_.unpark_all(park_mutex_);
+        }
+
+        /**
+         * @return true if the channel is closed
+         */
+        [[nodiscard]] bool closed() const noexcept {
+            return closed_.test(std::memory_order_acquire);
+        }
+
+        /**
+         * @return the version of the latest value, 0 if no value was pushed yet
+         */
+        [[nodiscard]] uint64_t version() const noexcept {
+            return version_.load(std::memory_order_acquire);
+        }
+
+        /**
+         * Construct a new version of the value in place and publish it to all subscribers.
+         * The value is constructed before any lock is taken, publishing it never waits for subscribers.
+         *
+         * @param args arguments to construct the value with
+         * @return true if the value was published, false if the channel was closed
+         */
+        template<typename ...Args>
+        bool emplace(Args &&...args) {
+            if (closed()) [[unlikely]] {
+                return false;
+            }
+
+            auto n = std::make_shared<node>(std::forward<Args>(args)...);
+            std::shared_ptr<node const> prev;
+
+            {
+                std::lock_guard lock{writer_mutex_};
+                if (closed()) [[unlikely]] {
+                    return false;
+                }
+
+                n->version = ++last_version_;
+                {
+                    std::lock_guard latest_lock{latest_mutex_};
+                    prev = std::exchange(latest_, std::move(n));
+                }
+                version_.store(last_version_, std::memory_order_release);
+            }
+
+            prev.reset(); // destroy the previous value (if no subscriber holds it anymore) outside the locks
+
+            has_new_version_.unpark(park_mutex_, std::numeric_limits<size_t>::max());
+            return true;
+        }
+
+        /**
+         * Publish a new version of the value to all subscribers.
+         * @see emplace
+         */
+        bool push(value_type const &value) {
+            return emplace(value);
+        }
+
+        /**
+         * Publish a new version of the value to all subscribers.
+         * @see emplace
+         */
+        bool push(value_type &&value) {
+            return emplace(std::move(value));
+        }
+
+        /**
+         * @return the latest snapshot, independent of any subscriber, std::nullopt if no value was pushed yet
+         */
+        [[nodiscard]] std::optional<snapshot_type> latest() const noexcept {
+            auto n = load_latest();
+            if (n == nullptr) {
+                return std::nullopt;
+            }
+            return make_snapshot(std::move(n));
+        }
+
+        /**
+         * Create a new subscriber that has not seen any version yet, i.e. its first pop() returns the latest value (if there is one).
+         * @return a new subscriber
+         */
+        [[nodiscard]] subscriber subscribe() noexcept {
+            return subscriber{*this};
+        }
+    };
+
+} // namespace dice::template_library
+
+#endif // DICE_TEMPLATELIBRARY_BROADCASTCHANNEL_HPP
@@ -1,45 +1,1939 @@
 #ifndef DICE_TEMPLATELIBRARY_CHANNEL_HPP
 #define DICE_TEMPLATELIBRARY_CHANNEL_HPP
 
+#include <dice/template-library/vec_deque.hpp>
+
+#include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <chrono>
+#include <concepts>
 #include <condition_variable>
+#include <coroutine>
 #include <cstddef>
-#include <deque>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <iterator>
+#include <memory>
 #include <mutex>
+#include <new>
 #include <optional>
+#include <ranges>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace dice::template_library {
+
+    /**
+     * The way a channel stores its elements
+     */
+    enum struct channel_storage : uint8_t {
+        locked_queue, ///< elements are stored in a queue that is protected by a mutex, producers and consumers block on condition variables
+        lock_free_ring, ///< elements are stored in a bounded lock-free ring buffer, threads only block if the channel is full or empty
+    };
+
+    /**
+     * Reason why a timed channel operation (e.g. channel::pop_for) did not succeed
+     */
+    enum struct channel_error : uint8_t {
+        closed, ///< the channel was closed (and, for pop operations, all elements were consumed)
+        timeout, ///< the deadline passed before the operation could be performed
+    };
+
+    /**
+     * Whether a channel collects statistics about its usage, see channel_stats
+     */
+    enum struct channel_instrumentation : bool {
+        disabled, ///< no statistics are collected, this has no overhead
+        enabled, ///< statistics are collected and can be retrieved via stats()
+    };
+
+    /**
+     * Snapshot of the statistics of a channel with channel_instrumentation::enabled
+     */
+    struct channel_stats {
+        size_t n_pushed = 0; ///< number of elements that were pushed into the channel
+        size_t n_popped = 0; ///< number of elements that were popped from the channel
+        size_t n_dropped = 0; ///< number of elements that were overwritten before they were popped (only exchange_channel drops elements)
+        size_t high_water_mark = 0; ///< maximum number of elements that were in the channel at the same time
+        std::chrono::nanoseconds push_wait_time{}; ///< total time producers spent blocked because the channel was full
+        std::chrono::nanoseconds pop_wait_time{}; ///< total time consumers spent blocked because the channel was empty
+    };
+
+    /**
+     * An executor for coroutines that were suspended in a channel operation (e.g. channel::co_pop).
+     * It is called with the handle of the coroutine once the operation completed and is responsible for resuming it,
+     * e.g. by calling the handle directly or by scheduling it on a thread pool.
+     * @note the executor is called while a channel operation of another thread is completing, it must not throw
+     */
+    template<typename Executor>
+    concept channel_executor = std::copy_constructible<Executor> && std::invocable<Executor &, std::coroutine_handle<>>;
+
+    namespace detail_channel {
+        /**
+         * Hint to the CPU that the calling thread is busy-waiting
+         */
+        inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+            asm volatile("yield" ::: "memory");
+#endif
+        }
+
+        /**
+         * false if WaitPolicy never spins, i.e. waiting threads can block right away.
+         * Policies that do not declare a static `spins` member are assumed to spin.
+         */
+        template<typename WaitPolicy>
+        inline constexpr bool wait_policy_spins = [] {
+            if constexpr (requires { { WaitPolicy::spins } -> std::convertible_to<bool>; }) {
+                return static_cast<bool>(WaitPolicy::spins);
+            } else {
+                return true;
+            }
+        }();
+    } // namespace detail_channel
+
+    /**
+     * Wait policy for channels: block threads right away, without spinning first
+     */
+    struct park_wait_policy {
+        static constexpr bool spins = false; ///< spin() never checks the condition
+
+        template<typename Check>
+        bool spin([[maybe_unused]] Check &&check) noexcept {
+            return false;
+        }
+    };
+
+    /**
+     * Wait policy for channels: before blocking a thread, spin n_spins times (with a CPU pause hint in between)
+     * and then yield n_yields times, checking the condition in between.
+     * This avoids the cost of blocking and waking up a thread if the condition is satisfied shortly after the thread started waiting.
+     *
+     * @tparam n_spins number of busy-waiting iterations
+     * @tparam n_yields number of std::this_thread::yield() iterations after spinning
+     */
+    template<uint32_t n_spins = 128, uint32_t n_yields = 4>
+    struct spin_wait_policy {
+        static constexpr bool spins = n_spins > 0 || n_yields > 0; ///< false if spin() never checks the condition
+
+        template<typename Check>
+        bool spin(Check &&check) noexcept(noexcept(check())) {
+            for (uint32_t ix = 0; ix < n_spins; ++ix) {
+                if (check()) {
+                    return true;
+                }
+                detail_channel::cpu_relax();
+            }
+
+            for (uint32_t ix = 0; ix < n_yields; ++ix) {
+                std::this_thread::yield();
+                if (check()) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+    };
+
+    /**
+     * Wait policy for channels: like spin_wait_policy, but the number of spins adapts to recent wait outcomes.
+     * If the condition was satisfied while spinning, the spin budget is doubled (up to max_spins),
+     * otherwise spinning was wasted and the budget is halved (down to min_spins).
+     * Therefore, threads only spin for long if that recently paid off.
+     * On machines with a single hardware thread, spinning cannot succeed and is skipped entirely.
+     *
+     * @tparam min_spins lower bound for the spin budget
+     * @tparam max_spins upper bound for the spin budget
+     * @tparam n_yields number of std::this_thread::yield() iterations after spinning
+     */
+    template<uint32_t min_spins = 16, uint32_t max_spins = 4096, uint32_t n_yields = 2>
+    struct adaptive_wait_policy {
+        static_assert(0 < min_spins && min_spins <= max_spins);
+
+        static constexpr bool spins = true;
+
+    private:
+        std::atomic<uint32_t> spin_budget_ = min_spins;
+
+        static bool is_multiprocessor() noexcept {
+            static bool const res = std::thread::hardware_concurrency() != 1;
+            return res;
+        }
+
+        void adjust_budget(uint32_t budget, bool spin_succeeded) noexcept {
+            auto const new_budget = spin_succeeded ? std::min(budget * 2, max_spins) : std::max(budget / 2, min_spins);
+            if (new_budget != budget) {
+                spin_budget_.store(new_budget, std::memory_order_relaxed);
+            }
+        }
+
+    public:
+        template<typename Check>
+        bool spin(Check &&check) noexcept(noexcept(check())) {
+            if (is_multiprocessor()) {
+                auto const budget = spin_budget_.load(std::memory_order_relaxed);
+                for (uint32_t ix = 0; ix < budget; ++ix) {
+                    if (check()) {
+                        adjust_budget(budget, true);
+                        return true;
+                    }
+                    detail_channel::cpu_relax();
+                }
+                adjust_budget(budget, false);
+            }
+
+            for (uint32_t ix = 0; ix < n_yields; ++ix) {
+                std::this_thread::yield();
+                if (check()) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+    };
+
+    namespace detail_channel {
+        /**
+         * Size of a cache line, used to keep independently modified atomics apart from each other
+         */
+        inline constexpr size_t cache_line_size = 64;
+
+        /**
+         * Blocking slow path for channels whose fast path is lock-free.
+         * Threads park on condvar_ while a condition does not hold, the threads modifying the state unpark them.
+         * All parking_spots of a channel share one mutex that is only ever locked if a thread needs to block.
+         *
+         * Before checking its condition, a parking thread increments n_parked_ followed by a seq_cst fence,
+         * an unparking thread modifies the state followed by a seq_cst fence and then reads n_parked_.
+         * Therefore, either the parking thread observes the modification or the unparking thread observes the parking thread.
+         */
+        struct parking_spot {
+        private:
+            std::atomic<size_t> n_parked_ = 0; ///< number of threads currently (about to be) parked
+            std::condition_variable condvar_;
+
+        public:
+            /**
+             * Block until pred() is true.
+             */
+            template<typename Pred>
+            void park(std::mutex &mutex, Pred pred) noexcept {
+                std::unique_lock lock{mutex};
+                n_parked_.fetch_add(1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                condvar_.wait(lock, pred);
+                n_parked_.fetch_sub(1, std::memory_order_relaxed);
+            }
+
+            /**
+             * Block until pred() is true or deadline has passed.
+             * @return the value of pred() when returning
+             */
+            template<typename Clock, typename Duration, typename Pred>
+            bool park_until(std::mutex &mutex, std::chrono::time_point<Clock, Duration> const &deadline, Pred pred) noexcept {
+                std::unique_lock lock{mutex};
+                n_parked_.fetch_add(1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                auto const res = condvar_.wait_until(lock, deadline, pred);
+                n_parked_.fetch_sub(1, std::memory_order_relaxed);
+                return res;
+            }
+
+            /**
+             * Wake up as many parked threads as are required to handle n modifications of the state, if there are any.
+             */
+            void unpark(std::mutex &mutex, size_t n = 1) noexcept {
+                if (n == 0) {
+                    return;
+                }
+
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (n_parked_.load(std::memory_order_relaxed) == 0) [[likely]] {
+                    return;
+                }
+
+                {
+                    // make sure the parking thread is either not yet checking its condition or already waiting on condvar_
+                    std::lock_guard lock{mutex};
+                }
+
+                if (n == 1) {
+                    condvar_.notify_one();
+                } else {
+                    condvar_.notify_all();
+                }
+            }
+
+            /**
+             * Wake up all parked threads.
+             */
+            void unpark_all(std::mutex &mutex) noexcept {
+                {
+                    // see unpark()
+                    std::lock_guard lock{mutex};
+                }
+                condvar_.notify_all();
+            }
+        };
+
+        /**
+         * Records the total time threads spent blocked, if instrumentation is enabled.
+         * If instrumentation is disabled, all operations are no-ops.
+         */
+        template<channel_instrumentation instrumentation>
+        struct blocked_time_counter {
+            struct time_point {
+            };
+
+            [[nodiscard]] time_point start() const noexcept {
+                return {};
+            }
+
+            void stop([[maybe_unused]] time_point start) noexcept {
+            }
+        };
+
+        template<>
+        struct blocked_time_counter<channel_instrumentation::enabled> {
+        private:
+            std::atomic<uint64_t> blocked_ns_ = 0;
+
+        public:
+            using time_point = std::chrono::steady_clock::time_point;
+
+            [[nodiscard]] time_point start() const noexcept {
+                return std::chrono::steady_clock::now();
+            }
+
+            void stop(time_point start) noexcept {
+                auto const blocked = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+                blocked_ns_.fetch_add(static_cast<uint64_t>(blocked.count()), std::memory_order_relaxed);
+            }
+
+            [[nodiscard]] std::chrono::nanoseconds total() const noexcept {
+                return std::chrono::nanoseconds{blocked_ns_.load(std::memory_order_relaxed)};
+            }
+        };
+
+        /**
+         * A parking_spot that first spins according to WaitPolicy before it parks a thread.
+         * If instrumentation is enabled, it additionally records the total time threads spent blocked (spinning or parked).
+         */
+        template<channel_instrumentation instrumentation, typename WaitPolicy>
+        struct channel_parking_spot {
+        private:
+            parking_spot spot_;
+            [[no_unique_address]] WaitPolicy wait_policy_;
+            [[no_unique_address]] blocked_time_counter<instrumentation> blocked_time_;
+
+        public:
+            template<typename Pred>
+            void park(std::mutex &mutex, Pred pred) noexcept {
+                if (pred()) {
+                    return;
+                }
+
+                auto const start = blocked_time_.start();
+                if (!wait_policy_.spin(pred)) {
+                    spot_.park(mutex, pred);
+                }
+                blocked_time_.stop(start);
+            }
+
+            template<typename Clock, typename Duration, typename Pred>
+            bool park_until(std::mutex &mutex, std::chrono::time_point<Clock, Duration> const &deadline, Pred pred) noexcept {
+                if (pred()) {
+                    return true;
+                }
+
+                auto const start = blocked_time_.start();
+                auto const res = wait_policy_.spin(pred) || spot_.park_until(mutex, deadline, pred);
+                blocked_time_.stop(start);
+                return res;
+            }
+
+            void unpark(std::mutex &mutex, size_t n = 1) noexcept {
+                spot_.unpark(mutex, n);
+            }
+
+            void unpark_all(std::mutex &mutex) noexcept {
+                spot_.unpark_all(mutex);
+            }
+
+            [[nodiscard]] std::chrono::nanoseconds blocked_time() const noexcept requires (instrumentation == channel_instrumentation::enabled) {
+                return blocked_time_.total();
+            }
+        };
+
+        /**
+         * A condition variable that first spins according to WaitPolicy before it blocks a thread.
+         * While spinning, the mutex is released and only briefly re-acquired (via try_lock) to check the predicate.
+         * If instrumentation is enabled, it additionally records the total time threads spent blocked (spinning or waiting).
+         *
+         * @tparam Mutex the mutex the waiting threads hold, std::condition_variable_any is used if it is not std::mutex
+         */
+        template<channel_instrumentation instrumentation, typename WaitPolicy, typename Mutex = std::mutex>
+        struct channel_condition_variable {
+        private:
+            std::conditional_t<std::is_same_v<Mutex, std::mutex>, std::condition_variable, std::condition_variable_any> condvar_;
+            [[no_unique_address]] WaitPolicy wait_policy_;
+            [[no_unique_address]] blocked_time_counter<instrumentation> blocked_time_;
+
+            /**
+             * Spin according to wait_policy_ until pred() is true.
+             * @return true if pred() became true while spinning, the lock is held in any case when this returns
+             */
+            template<typename Pred>
+            bool spin(std::unique_lock<Mutex> &lock, Pred &pred) {
+                if constexpr (!wait_policy_spins<WaitPolicy>) {
+                    // do not release and re-acquire the lock for nothing
+                    return false;
+                } else {
+                    lock.unlock();
+                    auto const res = wait_policy_.spin([&]() {
+                        if (!lock.try_lock()) {
+                            return false;
+                        }
+
+                        if (pred()) {
+                            return true;
+                        }
+
+                        lock.unlock();
+                        return false;
+                    });
+
+                    if (!res) {
+                        lock.lock();
+                    }
+                    return res;
+                }
+            }
+
+        public:
+            void notify_one() noexcept {
+                condvar_.notify_one();
+            }
+
+            void notify_all() noexcept {
+                condvar_.notify_all();
+            }
+
+            template<typename Pred>
+            void wait(std::unique_lock<Mutex> &lock, Pred pred) {
+                if (pred()) {
+                    return;
+                }
+
+                auto const start = blocked_time_.start();
+                if (!spin(lock, pred)) {
+                    condvar_.wait(lock, pred);
+                }
+                blocked_time_.stop(start);
+            }
+
+            template<typename Clock, typename Duration, typename Pred>
+            bool wait_until(std::unique_lock<Mutex> &lock, std::chrono::time_point<Clock, Duration> const &deadline, Pred pred) {
+                if (pred()) {
+                    return true;
+                }
+
+                auto const start = blocked_time_.start();
+                auto const res = spin(lock, pred) || condvar_.wait_until(lock, deadline, pred);
+                blocked_time_.stop(start);
+                return res;
+            }
+
+            [[nodiscard]] std::chrono::nanoseconds blocked_time() const noexcept requires (instrumentation == channel_instrumentation::enabled) {
+                return blocked_time_.total();
+            }
+        };
+
+        /**
+         * Counters for the statistics of a channel.
+         * If instrumentation is disabled, all operations are no-ops.
+         */
+        template<channel_instrumentation instrumentation>
+        struct channel_counters {
+            void add_pushed([[maybe_unused]] size_t n, [[maybe_unused]] size_t size_after) noexcept {
+            }
+
+            void add_popped([[maybe_unused]] size_t n) noexcept {
+            }
+
+            void add_dropped([[maybe_unused]] size_t n) noexcept {
+            }
+        };
+
+        template<>
+        struct channel_counters<channel_instrumentation::enabled> {
+        private:
+            std::atomic<size_t> n_pushed_ = 0;
+            std::atomic<size_t> n_popped_ = 0;
+            std::atomic<size_t> n_dropped_ = 0;
+            std::atomic<size_t> high_water_mark_ = 0;
+
+        public:
+            /**
+             * @param n number of pushed elements
+             * @param size_after number of elements in the channel after pushing
+             */
+            void add_pushed(size_t n, size_t size_after) noexcept {
+                n_pushed_.fetch_add(n, std::memory_order_relaxed);
+
+                auto hwm = high_water_mark_.load(std::memory_order_relaxed);
+                while (size_after > hwm && !high_water_mark_.compare_exchange_weak(hwm, size_after, std::memory_order_relaxed)) {
+                }
+            }
+
+            void add_popped(size_t n) noexcept {
+                n_popped_.fetch_add(n, std::memory_order_relaxed);
+            }
+
+            void add_dropped(size_t n) noexcept {
+                n_dropped_.fetch_add(n, std::memory_order_relaxed);
+            }
+
+            /**
+             * @return a snapshot of the counters, wait times are not filled in
+             */
+            [[nodiscard]] channel_stats snapshot() const noexcept {
+                return channel_stats{.n_pushed = n_pushed_.load(std::memory_order_relaxed),
+                                     .n_popped = n_popped_.load(std::memory_order_relaxed),
+                                     .n_dropped = n_dropped_.load(std::memory_order_relaxed),
+                                     .high_water_mark = high_water_mark_.load(std::memory_order_relaxed)};
+            }
+        };
+
+        /**
+         * A thread blocked in select(), waiting for any of several channels to change.
+         */
+        struct select_waiter {
+        private:
+            std::mutex mutex_;
+            std::condition_variable condvar_;
+            bool notified_ = false; ///< true if any of the channels changed since the last wait()
+
+        public:
+            /**
+             * Block until notify() was called since the last call to wait().
+             */
+            void wait() noexcept {
+                std::unique_lock lock{mutex_};
+                condvar_.wait(lock, [this]() noexcept { return notified_; });
+                notified_ = false;
+            }
+
+            void notify() noexcept {
+                {
+                    std::lock_guard lock{mutex_};
+                    notified_ = true;
+                }
+                condvar_.notify_one();
+            }
+        };
+
+        /**
+         * Registration of a select_waiter with a single channel, an element of an intrusive doubly linked list.
+         */
+        struct select_waiter_node {
+            select_waiter *waiter = nullptr;
+            select_waiter_node *prev = nullptr;
+            select_waiter_node *next = nullptr;
+        };
+
+        /**
+         * The select_waiters registered with a channel.
+         * This is shared by all channel types so that a single select_waiter can wait on any combination of them.
+         *
+         * Synchronization follows the same protocol as parking_spot: after registering, the waiter re-checks all channels,
+         * a channel first modifies its state and only then (after a seq_cst fence) checks for registered waiters.
+         */
+        struct select_waiter_list {
+        private:
+            std::atomic<size_t> n_waiters_ = 0; ///< number of registered waiters, allows skipping mutex_ on the fast path
+            std::mutex mutex_; ///< mutex for head_
+            select_waiter_node *head_ = nullptr;
+
+        public:
+            void add(select_waiter_node &node) noexcept {
+                {
+                    std::lock_guard lock{mutex_};
+                    node.prev = nullptr;
+                    node.next = head_;
+                    if (head_ != nullptr) {
+                        head_->prev = &node;
+                    }
+                    head_ = &node;
+                    n_waiters_.fetch_add(1, std::memory_order_relaxed);
+                }
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+            }
+
+            void remove(select_waiter_node &node) noexcept {
+                std::lock_guard lock{mutex_};
+                if (node.prev != nullptr) {
+                    node.prev->next = node.next;
+                } else {
+                    head_ = node.next;
+                }
+                if (node.next != nullptr) {
+                    node.next->prev = node.prev;
+                }
+                n_waiters_.fetch_sub(1, std::memory_order_relaxed);
+            }
+
+            /**
+             * Wake up all registered waiters, if there are any.
+             */
+            void notify_all() noexcept {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (n_waiters_.load(std::memory_order_relaxed) == 0) [[likely]] {
+                    return;
+                }
+
+                std::lock_guard lock{mutex_};
+                for (auto *node = head_; node != nullptr; node = node->next) {
+                    node->waiter->notify();
+                }
+            }
+        };
+
+        /**
+         * Grants select() access to the select_waiter_list of a channel.
+         */
+        struct select_access {
+            template<typename Channel>
+            static select_waiter_list &waiters(Channel &chan) noexcept {
+                return chan.select_waiters_;
+            }
+        };
+
+        /**
+         * A coroutine that is suspended in a channel operation, an element of an intrusive singly linked list.
+         */
+        struct co_waiter {
+            co_waiter *next_ = nullptr;
+            std::coroutine_handle<> handle_;
+            void (*schedule_)(co_waiter &) noexcept = nullptr; ///< hands handle_ to the executor of the waiter
+
+            /**
+             * Resume the suspended coroutine via its executor.
+             * @note the waiter is usually destroyed (together with the coroutine frame) by the time this returns
+             */
+            void schedule() noexcept {
+                schedule_(*this);
+            }
+        };
+
+        /**
+         * FIFO queue of co_waiters
+         */
+        struct co_waiter_queue {
+        private:
+            co_waiter *head_ = nullptr;
+            co_waiter *tail_ = nullptr;
+
+        public:
+            [[nodiscard]] bool empty() const noexcept {
+                return head_ == nullptr;
+            }
+
+            void push_back(co_waiter &waiter) noexcept {
+                waiter.next_ = nullptr;
+                if (tail_ == nullptr) {
+                    head_ = &waiter;
+                } else {
+                    tail_->next_ = &waiter;
+                }
+                tail_ = &waiter;
+            }
+
+            /**
+             * @pre !empty()
+             */
+            co_waiter &pop_front() noexcept {
+                assert(!empty());
+                auto &waiter = *head_;
+                head_ = waiter.next_;
+                if (head_ == nullptr) {
+                    tail_ = nullptr;
+                }
+                return waiter;
+            }
+
+            /**
+             * Move all waiters of other to the end of this queue
+             */
+            void append(co_waiter_queue &other) noexcept {
+                if (other.empty()) {
+                    return;
+                }
+
+                if (tail_ == nullptr) {
+                    head_ = other.head_;
+                } else {
+                    tail_->next_ = other.head_;
+                }
+                tail_ = other.tail_;
+                other.head_ = nullptr;
+                other.tail_ = nullptr;
+            }
+
+            /**
+             * Schedule all waiters and empty the queue.
+             * Must not be called while holding a lock of the channel, as the executor might resume the waiters inline.
+             */
+            void schedule_all() noexcept {
+                auto *waiter = std::exchange(head_, nullptr);
+                tail_ = nullptr;
+
+                while (waiter != nullptr) {
+                    // read next_ before scheduling, the waiter might be gone afterwards
+                    auto *next = waiter->next_;
+                    waiter->schedule();
+                    waiter = next;
+                }
+            }
+        };
+
+        /**
+         * A coroutine suspended in co_pop(), receives the element directly from the pushing thread
+         */
+        template<typename T>
+        struct co_pop_waiter : co_waiter {
+            std::optional<T> elem_; ///< the popped element, std::nullopt if the channel was closed
+        };
+
+        /**
+         * A coroutine suspended in co_push(), its element is moved into the channel by a popping thread
+         */
+        template<typename T>
+        struct co_push_waiter : co_waiter {
+            T *elem_ = nullptr; ///< the element to push
+            bool pushed_ = false; ///< true if the element was pushed, false if the channel was closed
+        };
+
+        /**
+         * Awaitable returned by co_pop() of a channel
+         */
+        template<typename Channel, typename Executor>
+        struct co_pop_awaiter : co_pop_waiter<typename Channel::value_type> {
+        private:
+            Channel *chan_;
+            [[no_unique_address]] Executor executor_;
+
+            static void schedule_impl(co_waiter &waiter) noexcept {
+                auto &self = static_cast<co_pop_awaiter &>(waiter);
+
+                // copy everything that is needed, the executor might resume the coroutine before it returns
+                auto executor = self.executor_;
+                std::invoke(executor, self.handle_);
+            }
+
+        public:
+            co_pop_awaiter(Channel &chan, Executor executor) noexcept(std::is_nothrow_move_constructible_v<Executor>)
+                : chan_{&chan},
+                  executor_{std::move(executor)} {
+            }
+
+            [[nodiscard]] bool await_ready() const noexcept {
+                return false;
+            }
+
+            /**
+             * @return false if the operation completed immediately and the coroutine does not need to be suspended
+             */
+            bool await_suspend(std::coroutine_handle<> handle) noexcept(std::is_nothrow_move_constructible_v<typename Channel::value_type>) {
+                this->handle_ = handle;
+                this->schedule_ = &schedule_impl;
+                return chan_->co_pop_suspend(*this);
+            }
+
+            /**
+             * @return std::nullopt if the channel was closed, an element otherwise
+             */
+            [[nodiscard]] std::optional<typename Channel::value_type> await_resume() noexcept(std::is_nothrow_move_constructible_v<typename Channel::value_type>) {
+                return std::move(this->elem_);
+            }
+        };
+
+        /**
+         * Awaitable returned by co_push() of a channel
+         */
+        template<typename Channel, typename Executor>
+        struct co_push_awaiter : co_push_waiter<typename Channel::value_type> {
+        private:
+            Channel *chan_;
+            typename Channel::value_type value_;
+            [[no_unique_address]] Executor executor_;
+
+            static void schedule_impl(co_waiter &waiter) noexcept {
+                auto &self = static_cast<co_push_awaiter &>(waiter);
+
+                // copy everything that is needed, the executor might resume the coroutine before it returns
+                auto executor = self.executor_;
+                std::invoke(executor, self.handle_);
+            }
+
+        public:
+            co_push_awaiter(Channel &chan, typename Channel::value_type &&value, Executor executor) noexcept(std::is_nothrow_move_constructible_v<typename Channel::value_type>
+                                                                                                                && std::is_nothrow_move_constructible_v<Executor>)
+                : chan_{&chan},
+                  value_{std::move(value)},
+                  executor_{std::move(executor)} {
+            }
+
+            [[nodiscard]] bool await_ready() const noexcept {
+                return false;
+            }
+
+            /**
+             * @return false if the operation completed immediately and the coroutine does not need to be suspended
+             */
+            bool await_suspend(std::coroutine_handle<> handle) noexcept(std::is_nothrow_move_constructible_v<typename Channel::value_type>) {
+                this->handle_ = handle;
+                this->schedule_ = &schedule_impl;
+                this->elem_ = &value_;
+                return chan_->co_push_suspend(*this);
+            }
+
+            /**
+             * @return true if pushing the element succeeded because the channel is not yet closed
+             */
+            [[nodiscard]] bool await_resume() const noexcept {
+                return this->pushed_;
+            }
+        };
+
+        /**
+         * Input iterator over all present and future elements of a channel
+         *
+         * @tparam Channel the channel type
+         */
+        template<typename Channel>
+        struct channel_iterator {
+            using channel_type = Channel;
+            using value_type = typename channel_type::value_type;
+            using difference_type = std::ptrdiff_t;
+            using reference = value_type &;
+            using const_reference = value_type const &;
+            using pointer = typename channel_type::pointer;
+            using const_pointer = typename channel_type::const_pointer;
+            using iterator_category = std::input_iterator_tag;
+
+        private:
+            channel_type *chan_;
+            mutable std::optional<value_type> buf_; ///< this has to be mutable for this iterator to fullfill std::input_iterator
+
+            void advance() noexcept {
+                buf_ = chan_->pop();
+            }
+
+        public:
+            explicit channel_iterator(channel_type *chan) noexcept : chan_{chan} {
+                advance();
+            }
+
+            channel_iterator(channel_iterator const &other) noexcept(std::is_nothrow_copy_constructible_v<value_type>)
+                : chan_{other.chan_},
+                  buf_{other.buf_} {
+            }
+
+            channel_iterator &operator=(channel_iterator const &other) noexcept(std::is_nothrow_copy_assignable_v<value_type>) {
+                if (this == &other) {
+                    return *this;
+                }
+
+                chan_ = other.chan_;
+                buf_ = other.buf_;
+                return *this;
+            }
+
+            channel_iterator(channel_iterator &&other) noexcept(std::is_nothrow_move_constructible_v<value_type>)
+                : chan_{other.chan_},
+                  buf_{std::move(other.buf_)} {
+            }
+
+            channel_iterator &operator=(channel_iterator &&other) noexcept(std::is_nothrow_swappable_v<value_type>) {
+                assert(this != &other);
+                std::swap(chan_, other.chan_);
+                std::swap(buf_, other.buf_);
+                return *this;
+            }
+
+            reference operator*() noexcept {
+                return *buf_;
+            }
+
+            reference operator*() const noexcept {
+                return *buf_;
+            }
+
+            pointer operator->() noexcept {
+                return &*buf_;
+            }
+
+            pointer operator->() const noexcept {
+                return &*buf_;
+            }
+
+            channel_iterator &operator++() noexcept {
+                advance();
+                return *this;
+            }
+
+            void operator++(int) noexcept {
+                advance();
+            }
+
+            bool operator==(std::default_sentinel_t) const noexcept {
+                return !buf_.has_value();
+            }
+        };
+
+        /**
+         * Input iterator over all present and future elements of a channel
+         * that removes elements from the channel in batches of up to max_batch_size elements (via Channel::pop_batch)
+         * to amortize the synchronization cost over many elements.
+         *
+         * @tparam Channel the channel type
+         */
+        template<typename Channel>
+        struct batched_channel_iterator {
+            using channel_type = Channel;
+            using value_type = typename channel_type::value_type;
+            using difference_type = std::ptrdiff_t;
+            using reference = value_type &;
+            using const_reference = value_type const &;
+            using pointer = typename channel_type::pointer;
+            using const_pointer = typename channel_type::const_pointer;
+            using iterator_category = std::input_iterator_tag;
+
+        private:
+            channel_type *chan_;
+            size_t max_batch_size_;
+            mutable std::vector<value_type> buf_; ///< this has to be mutable for this iterator to fullfill std::input_iterator
+            size_t pos_ = 0; ///< position of the current element in buf_
+
+            void refill() {
+                buf_.clear();
+                pos_ = 0;
+                chan_->pop_batch(std::back_inserter(buf_), max_batch_size_);
+            }
+
+        public:
+            batched_channel_iterator(channel_type *chan, size_t max_batch_size) : chan_{chan},
+                                                                                 max_batch_size_{max_batch_size} {
+                assert(max_batch_size_ > 0);
+                buf_.reserve(max_batch_size_);
+                refill();
+            }
+
+            reference operator*() const noexcept {
+                return buf_[pos_];
+            }
+
+            pointer operator->() const noexcept {
+                return &buf_[pos_];
+            }
+
+            batched_channel_iterator &operator++() {
+                if (++pos_ == buf_.size()) {
+                    refill();
+                }
+                return *this;
+            }
+
+            void operator++(int) {
+                ++*this;
+            }
+
+            bool operator==(std::default_sentinel_t) const noexcept {
+                return buf_.empty();
+            }
+        };
+
+        /**
+         * A range over all present and future elements of a channel that removes elements in batches.
+         * See batched_channel_iterator.
+         *
+         * @tparam Channel the channel type
+         */
+        template<typename Channel>
+        struct batched_channel_view {
+            using iterator = batched_channel_iterator<Channel>;
+            using sentinel = std::default_sentinel_t;
+
+        private:
+            Channel *chan_;
+            size_t max_batch_size_;
+
+        public:
+            batched_channel_view(Channel *chan, size_t max_batch_size) noexcept : chan_{chan},
+                                                                                 max_batch_size_{max_batch_size} {
+            }
+
+            [[nodiscard]] iterator begin() const {
+                return iterator{chan_, max_batch_size_};
+            }
+
+            [[nodiscard]] sentinel end() const noexcept {
+                return std::default_sentinel;
+            }
+        };
+    } // namespace detail_channel
+
+	/**
+     * A multi producer, multi consumer channel/queue
+     * @warning close() must be called once the producing threads are done, otherwise the reading thread will hang indefinitely
+     *
+     * @tparam T value type of the channel
+     * @tparam storage how the elements of the channel are stored, see channel_storage
+     * @tparam instrumentation whether the channel collects statistics, see channel_stats
+     * @tparam WaitPolicy how threads wait before they block, see park_wait_policy, spin_wait_policy and adaptive_wait_policy
+     * @tparam Mutex the mutex protecting the queue (satisfying Lockable, e.g. spin_futex_mutex), only used by channel_storage::locked_queue
+     */
+    template<typename T, channel_storage storage = channel_storage::locked_queue, channel_instrumentation instrumentation = channel_instrumentation::disabled,
+             typename WaitPolicy = adaptive_wait_policy<>, typename Mutex = std::mutex>
+    struct channel {
+        using value_type = T;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = value_type &;
+        using const_reference = value_type const &;
+        using pointer = T *;
+        using const_pointer = T const *;
+
+    private:
+        size_t max_cap_; ///< maximum allowed number of elements in queue_
+        vec_deque<T> queue_; ///< queue for elements
+
+        std::atomic_flag closed_ = ATOMIC_FLAG_INIT; ///< true if this channel is closed
+        Mutex queue_mutex_; ///< mutex for queue_
+        detail_channel::channel_condition_variable<instrumentation, WaitPolicy, Mutex> queue_not_empty_; ///< condvar for queue_.size() > 0
+        detail_channel::channel_condition_variable<instrumentation, WaitPolicy, Mutex> queue_not_full_;  ///< condvar for queue_.size() < max_cap_;
+        [[no_unique_address]] detail_channel::channel_counters<instrumentation> counters_; ///< statistics, empty if instrumentation is disabled
+        detail_channel::select_waiter_list select_waiters_; ///< threads in select() waiting for this channel
+        detail_channel::co_waiter_queue co_pop_waiters_; ///< coroutines suspended in co_pop(), can only be non-empty if queue_ is empty
+        detail_channel::co_waiter_queue co_push_waiters_; ///< coroutines suspended in co_push(), can only be non-empty if queue_ is full
+
+        friend struct detail_channel::select_access;
+
+        template<typename Channel, typename Executor>
+        friend struct detail_channel::co_pop_awaiter;
+
+        template<typename Channel, typename Executor>
+        friend struct detail_channel::co_push_awaiter;
+
+        /**
+         * Wake up as many waiting threads as are required to handle n changes to queue_
+         */
+        template<typename CondVar>
+        static void notify_n(CondVar &condvar, size_t n) noexcept {
+            if (n == 1) {
+                condvar.notify_one();
+            } else if (n > 1) {
+                condvar.notify_all();
+            }
+        }
+
+        /**
+         * Wake up the threads waiting for n new elements in queue_
+         */
+        void notify_not_empty(size_t n) noexcept {
+            notify_n(queue_not_empty_, n);
+            if (n > 0) {
+                select_waiters_.notify_all();
+            }
+        }
+
+        /**
+         * Add an element to the channel, the element is handed directly to a coroutine suspended in co_pop() if there is one.
+         * @pre queue_mutex_ is held and queue_.size() < max_cap_
+         *
+         * @param ready receives the co_pop() waiter that received the element, it needs to be scheduled after queue_mutex_ was released
+         * @param args constructor args
+         */
+        template<typename ...Args>
+        void enqueue(detail_channel::co_waiter_queue &ready, Args &&...args) noexcept(std::is_nothrow_constructible_v<value_type, decltype(std::forward<Args>(args))...>) {
+            if (!co_pop_waiters_.empty()) [[unlikely]] {
+                auto &waiter = static_cast<detail_channel::co_pop_waiter<value_type> &>(co_pop_waiters_.pop_front());
+                waiter.elem_.emplace(std::forward<Args>(args)...);
+                ready.push_back(waiter);
+                counters_.add_pushed(1, 1);
+                counters_.add_popped(1);
+                return;
+            }
+
+            queue_.emplace_back(std::forward<Args>(args)...);
+            counters_.add_pushed(1, queue_.size());
+        }
+
+        /**
+         * Move the elements of coroutines suspended in co_push() into the free capacity of queue_.
+         * @pre queue_mutex_ is held
+         *
+         * @param ready receives the co_push() waiters whose elements were pushed, they need to be scheduled after queue_mutex_ was released
+         */
+        void admit_co_pushers(detail_channel::co_waiter_queue &ready) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            while (!co_push_waiters_.empty() && queue_.size() < max_cap_) [[unlikely]] {
+                auto &waiter = static_cast<detail_channel::co_push_waiter<value_type> &>(co_push_waiters_.pop_front());
+                queue_.emplace_back(std::move(*waiter.elem_));
+                waiter.pushed_ = true;
+                ready.push_back(waiter);
+                counters_.add_pushed(1, queue_.size());
+            }
+        }
+
+        /**
+         * Remove the first element of queue_.
+         * @pre queue_mutex_ is held and !queue_.empty()
+         *
+         * @param ready see admit_co_pushers
+         */
+        value_type take_front(detail_channel::co_waiter_queue &ready) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            auto ret = std::move(queue_.front());
+            queue_.pop_front();
+            counters_.add_popped(1);
+            admit_co_pushers(ready);
+            return ret;
+        }
+
+        /**
+         * Move up to max_n elements from the front of queue_ to out.
+         * @pre queue_mutex_ is held
+         *
+         * @param ready see admit_co_pushers
+         */
+        template<typename OutputIt>
+        size_t move_out(OutputIt &out, size_t max_n, detail_channel::co_waiter_queue &ready) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            auto const n = std::min(max_n, queue_.size());
+            for (size_t ix = 0; ix < n; ++ix) {
+                *out = std::move(queue_.front());
+                ++out;
+                queue_.pop_front();
+            }
+            counters_.add_popped(n);
+            admit_co_pushers(ready);
+            return n;
+        }
+
+        /**
+         * Called by co_pop_awaiter::await_suspend
+         * @return true if the coroutine needs to be suspended
+         */
+        bool co_pop_suspend(detail_channel::co_pop_waiter<value_type> &waiter) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            detail_channel::co_waiter_queue ready;
+
+            std::unique_lock lock{queue_mutex_};
+            if (queue_.empty()) {
+                if (closed_.test(std::memory_order_relaxed)) [[unlikely]] {
+                    // relaxed is enough because we hold the lock
+                    return false;
+                }
+
+                co_pop_waiters_.push_back(waiter);
+                return true;
+            }
+
+            waiter.elem_.emplace(take_front(ready));
+
+            lock.unlock();
+            queue_not_full_.notify_one();
+            ready.schedule_all();
+            return false;
+        }
+
+        /**
+         * Called by co_push_awaiter::await_suspend
+         * @return true if the coroutine needs to be suspended
+         */
+        bool co_push_suspend(detail_channel::co_push_waiter<value_type> &waiter) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            detail_channel::co_waiter_queue ready;
+
+            std::unique_lock lock{queue_mutex_};
+            if (closed_.test(std::memory_order_relaxed)) [[unlikely]] {
+                // relaxed is enough because we hold the lock
+                waiter.pushed_ = false;
+                return false;
+            }
+
+            if (queue_.size() >= max_cap_) {
+                co_push_waiters_.push_back(waiter);
+                return true;
+            }
+
+            enqueue(ready, std::move(*waiter.elem_));
+            waiter.pushed_ = true;
+
+            lock.unlock();
+            notify_not_empty(1);
+            ready.schedule_all();
+            return false;
+        }
+
+    public:
+        /**
+         * @param capacity maximum number of elements the channel can hold.
+         * @note memory for all `capacity` elements is allocated up front, the channel does not allocate after construction
+         */
+        explicit channel(size_t capacity) : max_cap_{capacity} {
+            queue_.reserve(max_cap_);
+        }
+
+        // there is no way to safely implement these with concurrent access
+        channel(channel const &other) = delete;
+        channel(channel &&other) = delete;
+        channel &operator=(channel const &other) = delete;
+        channel &operator=(channel &&other) noexcept = delete;
+
+        ~channel() noexcept = default;
+
+		/**
+         * Close the channel.
+         * After calling close calls to push() will return false
+         * and calls to try_pop will return std::nullopt once the already present elements are exhausted
+         */
+        void close() noexcept {
+            detail_channel::co_waiter_queue ready;
+
+            {
+                // "Even if the shared variable is atomic, it must be modified while owning the mutex to correctly publish the modification to the waiting thread."
+                // - https://en.cppreference.com/w/cpp/thread/condition_variable
+                //
+                // Here closed_ is the shared variable used by queue_not_empty_ in another thread (the one waiting in try_pop)
+                std::lock_guard lock{queue_mutex_};
+                closed_.test_and_set(std::memory_order_release);
+
+                // suspended co_pop()s and co_push()s fail, their results are already in the right state
+                ready.append(co_pop_waiters_);
+                ready.append(co_push_waiters_);
+            }
+            queue_not_empty_.notify_all(); // notify pop() so that it does not get stuck
+            queue_not_full_.notify_all(); // notify emplace()
+            select_waiters_.notify_all(); // notify select()
+            ready.schedule_all(); // resume co_pop() and co_push()
+        }
+
+		/**
+         * @return true if this channel is closed
+         */
+        [[nodiscard]] bool closed() const noexcept {
+            return closed_.test(std::memory_order_acquire);
+        }
+
+        /**
+         * @return true if this channel is closed and all elements were consumed, i.e. no element will ever be available again
+         */
+        [[nodiscard]] bool drained() noexcept {
+            if (!closed_.test(std::memory_order_acquire)) {
+                return false;
+            }
+
+            std::lock_guard lock{queue_mutex_};
+            return queue_.empty();
+        }
+
+        /**
+         * @return a snapshot of the statistics of this channel
+         */
+        [[nodiscard]] channel_stats stats() const noexcept requires (instrumentation == channel_instrumentation::enabled) {
+            auto ret = counters_.snapshot();
+            ret.push_wait_time = queue_not_full_.blocked_time();
+            ret.pop_wait_time = queue_not_empty_.blocked_time();
+            return ret;
+        }
+
+		/**
+         * Emplace an element into the channel, blocks if there is no capacity left in the channel.
+         *
+         * @param args constructor args
+         * @return true if emplacing the element succeeded because the channel is not yet closed
+         */
+        template<typename ...Args>
+        bool emplace(Args &&...args) noexcept(std::is_nothrow_constructible_v<value_type, decltype(std::forward<Args>(args))...>) {
+            if (closed_.test(std::memory_order_acquire)) [[unlikely]] {
+                return false;
+            }
+
+            detail_channel::co_waiter_queue ready;
+
+            {
+                std::unique_lock lock{queue_mutex_};
+                queue_not_full_.wait(lock, [this]() noexcept { return queue_.size() < max_cap_ || closed_.test(std::memory_order_relaxed); });
+
+                if (closed_.test(std::memory_order_relaxed)) [[unlikely]] {
+                    // relaxed is enough because we hold the lock
+                    // wait was exited because closed_ was true (channel closed)
+                    return false;
+                }
+
+                enqueue(ready, std::forward<Args>(args)...);
+            }
+
+            notify_not_empty(1);
+            ready.schedule_all();
+            return true;
+        }
+
+        /**
+         * Emplace an element into the channel, returns immediately if there is no capacity in the channel.
+         *
+         * @param args constructor args
+         * @return true if emplacing the element succeeded
+         */
+        template<typename ...Args>
+        bool try_emplace(Args &&...args) noexcept(std::is_nothrow_constructible_v<value_type, decltype(std::forward<Args>(args))...>) {
+            if (closed_.test(std::memory_order_acquire)) [[unlikely]] {
+                return false;
+            }
+
+            detail_channel::co_waiter_queue ready;
+
+            {
+                std::unique_lock lock{queue_mutex_};
+                if (queue_.size() >= max_cap_ || closed_.test(std::memory_order_relaxed)) {
+                    // relaxed is enough because we hold the lock
+                    return false;
+                }
+
+                enqueue(ready, std::forward<Args>(args)...);
+            }
+
+            notify_not_empty(1);
+            ready.schedule_all();
+            return true;
+        }
+
+		/**
+         * Push a single element into the channel, blocks if there is no capacity left in the channel.
+         *
+         * @param value the element to push
+         * @return true if pushing the element succeeded because the channel is not yet closed
+         */
+        bool push(value_type const &value) noexcept(std::is_nothrow_copy_constructible_v<value_type>) {
+            return emplace(value);
+        }
+
+        /**
+         * Push a single element into the channel, returns immediately if there is no capacity in the channel.
+         *
+         * @param value the element to push
+         * @return true if pushing the element succeeded because the channel is not yet closed
+         */
+        bool try_push(value_type const &value) noexcept(std::is_nothrow_copy_constructible_v<value_type>) {
+            return try_emplace(value);
+        }
+
+        /**
+         * Push a single element into the channel, blocks if there is no capacity left in the channel.
+         *
+         * @param value the element to push
+         * @return true if pushing the element succeeded because the channel is not yet closed
+         */
+        bool push(value_type &&value) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            return emplace(std::move(value));
+        }
+
+        /**
+         * Push a single element into the channel, returns immediately if there is no capacity in the channel.
+         *
+         * @param value the element to push
+         * @return true if pushing the element succeeded because the channel is not yet closed
+         */
+        bool try_push(value_type &&value) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            return try_emplace(std::move(value));
+        }
+
+        /**
+         * Emplace an element into the channel, blocks until deadline if there is no capacity left in the channel.
+         *
+         * @param deadline point in time after which to give up
+         * @param args constructor args
+         * @return nothing on success, channel_error::closed if the channel is closed or channel_error::timeout if there was no capacity until deadline
+         */
+        template<typename Clock, typename Duration, typename ...Args>
+        std::expected<void, channel_error> emplace_until(std::chrono::time_point<Clock, Duration> const &deadline, Args &&...args) noexcept(std::is_nothrow_constructible_v<value_type, decltype(std::forward<Args>(args))...>) {
+            if (closed_.test(std::memory_order_acquire)) [[unlikely]] {
+                return std::unexpected{channel_error::closed};
+            }
+
+            detail_channel::co_waiter_queue ready;
+
+            {
+                std::unique_lock lock{queue_mutex_};
+                if (!queue_not_full_.wait_until(lock, deadline, [this]() noexcept { return queue_.size() < max_cap_ || closed_.test(std::memory_order_relaxed); })) {
+                    return std::unexpected{channel_error::timeout};
+                }
+
+                if (closed_.test(std::memory_order_relaxed)) [[unlikely]] {
+                    // relaxed is enough because we hold the lock
+                    return std::unexpected{channel_error::closed};
+                }
+
+                enqueue(ready, std::forward<Args>(args)...);
+            }
+
+            notify_not_empty(1);
+            ready.schedule_all();
+            return {};
+        }
+
+        /**
+         * Emplace an element into the channel, blocks for at most timeout if there is no capacity left in the channel.
+         *
+         * @param timeout maximum duration to wait for capacity
+         * @param args constructor args
+         * @return nothing on success, channel_error::closed if the channel is closed or channel_error::timeout if there was no capacity in time
+         */
+        template<typename Rep, typename Period, typename ...Args>
+        std::expected<void, channel_error> emplace_for(std::chrono::duration<Rep, Period> const &timeout, Args &&...args) noexcept(std::is_nothrow_constructible_v<value_type, decltype(std::forward<Args>(args))...>) {
+            return emplace_until(std::chrono::steady_clock::now() + timeout, std::forward<Args>(args)...);
+        }
+
+        /**
+         * Push a single element into the channel, blocks until deadline if there is no capacity left in the channel.
+         *
+         * @param value the element to push
+         * @param deadline point in time after which to give up
+         * @return nothing on success, channel_error::closed if the channel is closed or channel_error::timeout if there was no capacity until deadline
+         */
+        template<typename Clock, typename Duration>
+        std::expected<void, channel_error> push_until(value_type const &value, std::chrono::time_point<Clock, Duration> const &deadline) noexcept(std::is_nothrow_copy_constructible_v<value_type>) {
+            return emplace_until(deadline, value);
+        }
+
+        /**
+         * Push a single element into the channel, blocks until deadline if there is no capacity left in the channel.
+         *
+         * @param value the element to push
+         * @param deadline point in time after which to give up
+         * @return nothing on success, channel_error::closed if the channel is closed or channel_error::timeout if there was no capacity until deadline
+         */
+        template<typename Clock, typename Duration>
+        std::expected<void, channel_error> push_until(value_type &&value, std::chrono::time_point<Clock, Duration> const &deadline) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            return emplace_until(deadline, std::move(value));
+        }
+
+        /**
+         * Push a single element into the channel, blocks for at most timeout if there is no capacity left in the channel.
+         *
+         * @param value the element to push
+         * @param timeout maximum duration to wait for capacity
+         * @return nothing on success, channel_error::closed if the channel is closed or channel_error::timeout if there was no capacity in time
+         */
+        template<typename Rep, typename Period>
+        std::expected<void, channel_error> push_for(value_type const &value, std::chrono::duration<Rep, Period> const &timeout) noexcept(std::is_nothrow_copy_constructible_v<value_type>) {
+            return emplace_for(timeout, value);
+        }
+
+        /**
+         * Push a single element into the channel, blocks for at most timeout if there is no capacity left in the channel.
+         *
+         * @param value the element to push
+         * @param timeout maximum duration to wait for capacity
+         * @return nothing on success, channel_error::closed if the channel is closed or channel_error::timeout if there was no capacity in time
+         */
+        template<typename Rep, typename Period>
+        std::expected<void, channel_error> push_for(value_type &&value, std::chrono::duration<Rep, Period> const &timeout) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            return emplace_for(timeout, std::move(value));
+        }
+
+        /**
+         * Push all elements of a range into the channel.
+         * Blocks while there is no capacity left in the channel. Every time capacity becomes available
+         * as many elements as fit are pushed under a single lock acquisition followed by a single notification.
+         *
+         * @param range the elements to push, elements are constructed from `*it` (wrap the range in `std::views::as_rvalue` to move them)
+         * @return the number of elements pushed. This is less than the size of range only if the channel was closed.
+         */
+        template<std::ranges::input_range R>
+        size_t push_range(R &&range) noexcept(std::is_nothrow_constructible_v<value_type, std::ranges::range_reference_t<R>>) {
+            if (closed_.test(std::memory_order_acquire)) [[unlikely]] {
+                return 0;
+            }
+
+            auto it = std::ranges::begin(range);
+            auto const end = std::ranges::end(range);
+
+            size_t n_pushed = 0;
+            while (it != end) {
+                size_t n_batch = 0;
+                detail_channel::co_waiter_queue ready;
+
+                {
+                    std::unique_lock lock{queue_mutex_};
+                    queue_not_full_.wait(lock, [this]() noexcept { return queue_.size() < max_cap_ || closed_.test(std::memory_order_relaxed); });
+
+                    if (closed_.test(std::memory_order_relaxed)) [[unlikely]] {
+                        // relaxed is enough because we hold the lock
+                        break;
+                    }
+
+                    for (; it != end && queue_.size() < max_cap_; ++it, ++n_batch) {
+                        enqueue(ready, *it);
+                    }
+                }
+
+                notify_not_empty(n_batch);
+                ready.schedule_all();
+                n_pushed += n_batch;
+            }
+
+            return n_pushed;
+        }
+
+        /**
+         * Push as many elements of a range into the channel as there is capacity for, returns immediately if there is no capacity in the channel.
+         * All elements are pushed under a single lock acquisition followed by a single notification.
+         *
+         * @param range the elements to push, elements are constructed from `*it` (wrap the range in `std::views::as_rvalue` to move them)
+         * @return the number of elements pushed
+         */
+        template<std::ranges::input_range R>
+        size_t try_push_range(R &&range) noexcept(std::is_nothrow_constructible_v<value_type, std::ranges::range_reference_t<R>>) {
+            if (closed_.test(std::memory_order_acquire)) [[unlikely]] {
+                return 0;
+            }
+
+            size_t n_pushed = 0;
+
+            detail_channel::co_waiter_queue ready;
+
+            {
+                std::unique_lock lock{queue_mutex_};
+                if (closed_.test(std::memory_order_relaxed)) [[unlikely]] {
+                    // relaxed is enough because we hold the lock
+                    return 0;
+                }
+
+                auto it = std::ranges::begin(range);
+                auto const end = std::ranges::end(range);
+                for (; it != end && queue_.size() < max_cap_; ++it, ++n_pushed) {
+                    enqueue(ready, *it);
+                }
+            }
+
+            notify_not_empty(n_pushed);
+            ready.schedule_all();
+            return n_pushed;
+        }
+
+		/**
+         * Try to get a (previously pushed) element from the channel.
+         * If there is no element available, blocks until there is one available or the channel is closed.
+         *
+         * @return std::nullopt if the channel was closed, an element otherwise
+         */
+        [[nodiscard]] std::optional<value_type> pop() noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            detail_channel::co_waiter_queue ready;
+
+            std::unique_lock lock{queue_mutex_};
+            queue_not_empty_.wait(lock, [this]() noexcept { return !queue_.empty() || closed_.test(std::memory_order_relaxed); });
+
+            if (queue_.empty()) [[unlikely]] {
+                // implies closed_ == true
+                return std::nullopt;
+            }
+
+            auto ret = take_front(ready);
+
+            lock.unlock();
+            queue_not_full_.notify_one();
+            ready.schedule_all();
+            return ret;
+        }
+
+        /**
+         * Try to get a (previously pushed) element from the channel.
+         * Unlike pop(), if there is no element available, returns std::nullopt immediatly.
+         */
+        [[nodiscard]] std::optional<value_type> try_pop() noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            detail_channel::co_waiter_queue ready;
+
+            std::unique_lock lock{queue_mutex_};
+            if (queue_.empty()) {
+                return std::nullopt;
+            }
+
+            auto ret = take_front(ready);
+
+            lock.unlock();
+            queue_not_full_.notify_one();
+            ready.schedule_all();
+            return ret;
+        }
+
+        /**
+         * Try to get a (previously pushed) element from the channel.
+         * If there is no element available, blocks until there is one available, the channel is closed or deadline has passed.
+         *
+         * @param deadline point in time after which to give up
+         * @return an element, or channel_error::closed if the channel was closed or channel_error::timeout if there was no element until deadline
+         */
+        template<typename Clock, typename Duration>
+        [[nodiscard]] std::expected<value_type, channel_error> pop_until(std::chrono::time_point<Clock, Duration> const &deadline) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            detail_channel::co_waiter_queue ready;
+
+            std::unique_lock lock{queue_mutex_};
+            if (!queue_not_empty_.wait_until(lock, deadline, [this]() noexcept { return !queue_.empty() || closed_.test(std::memory_order_relaxed); })) {
+                return std::unexpected{channel_error::timeout};
+            }
+
+            if (queue_.empty()) [[unlikely]] {
+                // implies closed_ == true
+                return std::unexpected{channel_error::closed};
+            }
+
+            auto ret = take_front(ready);
+
+            lock.unlock();
+            queue_not_full_.notify_one();
+            ready.schedule_all();
+            return ret;
+        }
+
+        /**
+         * Try to get a (previously pushed) element from the channel.
+         * If there is no element available, blocks until there is one available, the channel is closed or timeout has elapsed.
+         *
+         * @param timeout maximum duration to wait for an element
+         * @return an element, or channel_error::closed if the channel was closed or channel_error::timeout if there was no element in time
+         */
+        template<typename Rep, typename Period>
+        [[nodiscard]] std::expected<value_type, channel_error> pop_for(std::chrono::duration<Rep, Period> const &timeout) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            return pop_until(std::chrono::steady_clock::now() + timeout);
+        }
+
+        /**
+         * Get up to max_batch_size (previously pushed) elements from the channel.
+         * If there is no element available, blocks until there is at least one available or the channel is closed.
+         * All elements are removed under a single lock acquisition followed by a single notification.
+         *
+         * @param out output iterator the elements are moved to
+         * @param max_batch_size maximum number of elements to get, must be greater than 0
+         * @return the number of elements written to out, 0 if the channel was closed
+         */
+        template<std::output_iterator<value_type &&> OutputIt>
+        size_t pop_batch(OutputIt out, size_t max_batch_size) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            assert(max_batch_size > 0);
+
+            detail_channel::co_waiter_queue ready;
+
+            std::unique_lock lock{queue_mutex_};
+            queue_not_empty_.wait(lock, [this]() noexcept { return !queue_.empty() || closed_.test(std::memory_order_relaxed); });
+
+            auto const n = move_out(out, max_batch_size, ready);
+
+            lock.unlock();
+            notify_n(queue_not_full_, n);
+            ready.schedule_all();
+            return n;
+        }
+
+        /**
+         * Get up to max_batch_size (previously pushed) elements from the channel.
+         * Unlike pop_batch(), if there is no element available, returns 0 immediately.
+         *
+         * @param out output iterator the elements are moved to
+         * @param max_batch_size maximum number of elements to get
+         * @return the number of elements written to out
+         */
+        template<std::output_iterator<value_type &&> OutputIt>
+        size_t try_pop_batch(OutputIt out, size_t max_batch_size) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            detail_channel::co_waiter_queue ready;
+
+            std::unique_lock lock{queue_mutex_};
+            auto const n = move_out(out, max_batch_size, ready);
+
+            lock.unlock();
+            notify_n(queue_not_full_, n);
+            ready.schedule_all();
+            return n;
+        }
+
+        /**
+         * Get a (previously pushed) element from the channel without blocking the calling thread.
+         * If there is no element available, the awaiting coroutine is suspended until there is one available or the channel is closed.
+         * The element is then handed directly to the coroutine, which is resumed via executor.
+         *
+         * @param executor called with the handle of the suspended coroutine once it can be resumed, see channel_executor
+         * @return awaitable that results in std::nullopt if the channel was closed, an element otherwise
+         * @note if an element is available right away, the coroutine continues without being suspended
+         */
+        template<channel_executor Executor>
+        [[nodiscard]] detail_channel::co_pop_awaiter<channel, Executor> co_pop(Executor executor) noexcept(std::is_nothrow_move_constructible_v<Executor>) {
+            return detail_channel::co_pop_awaiter<channel, Executor>{*this, std::move(executor)};
+        }
+
+        /**
+         * Push a single element into the channel without blocking the calling thread.
+         * If there is no capacity left in the channel, the awaiting coroutine is suspended until the element could be pushed
+         * or the channel is closed, it is then resumed via executor.
+         *
+         * @param value the element to push
+         * @param executor called with the handle of the suspended coroutine once it can be resumed, see channel_executor
+         * @return awaitable that results in true if pushing the element succeeded because the channel is not yet closed
+         * @note if there is capacity left, the coroutine continues without being suspended
+         */
+        template<channel_executor Executor>
+        [[nodiscard]] detail_channel::co_push_awaiter<channel, Executor> co_push(value_type value, Executor executor) noexcept(std::is_nothrow_move_constructible_v<value_type>
+                                                                                                                            && std::is_nothrow_move_constructible_v<Executor>) {
+            return detail_channel::co_push_awaiter<channel, Executor>{*this, std::move(value), std::move(executor)};
+        }
+
+        using iterator = detail_channel::channel_iterator<channel>;
+        using batched_view = detail_channel::batched_channel_view<channel>;
+        using sentinel = std::default_sentinel_t;
+
+		/**
+         * @return an iterator over all present and future elements of this channel
+         * @note iterator == end() is true once the channel is closed
+         */
+        [[nodiscard]] iterator begin() noexcept {
+            return iterator{this};
+        }
+
+        [[nodiscard]] sentinel end() const noexcept {
+            return std::default_sentinel;
+        }
+
+        /**
+         * @param max_batch_size maximum number of elements that are removed from the channel at once, must be greater than 0
+         * @return a range over all present and future elements of this channel, that removes elements from the channel in batches (see pop_batch)
+         * @note like begin()/end(), the range ends once the channel is closed
+         * @warning elements that were removed from the channel but not yet reached by the iteration are lost if the iteration is stopped early
+         */
+        [[nodiscard]] batched_view batched(size_t max_batch_size) noexcept {
+            return batched_view{this, max_batch_size};
+        }
+    };
+
+    /**
+     * A multi producer, multi consumer channel/queue that is backed by a bounded lock-free ring buffer.
+     * The ring buffer is allocated once, with exactly `capacity` slots, when the channel is constructed.
+     *
+     * Producers and consumers only synchronize via atomic operations on the ring buffer (see https://github.com/rigtorp/MPMCQueue for the algorithm).
+     * A thread only blocks (i.e. parks on a condition variable) if the channel is actually full (for producers) or empty (for consumers).
+     * This storage does not provide co_pop()/co_push(), suspended coroutines need to be queued under a lock which would defeat its purpose.
+     * T must be nothrow move constructible. Elements are constructed in place once a slot of the ring buffer is claimed, i.e. arguments are only consumed
+     * if there is capacity. If the constructor throws, the claimed slot is still published, but marked to be skipped by consumers
+     * (it counts towards the capacity until the next consumer passes it).
+     *
+     * @warning close() must be called once the producing threads are done, otherwise the reading thread will hang indefinitely
+     *
+     * @tparam T value type of the channel
+     * @tparam instrumentation whether the channel collects statistics, see channel_stats
+     * @tparam WaitPolicy how threads wait before they block, see park_wait_policy, spin_wait_policy and adaptive_wait_policy
+     * @tparam Mutex unused, the ring buffer is lock-free and only locks internally to park threads
+     */
+    template<typename T, channel_instrumentation instrumentation, typename WaitPolicy, typename Mutex>
+    struct channel<T, channel_storage::lock_free_ring, instrumentation, WaitPolicy, Mutex> {
+        using value_type = T;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = value_type &;
+        using const_reference = value_type const &;
+        using pointer = T *;
+        using const_pointer = T const *;
+
+        static_assert(std::is_nothrow_move_constructible_v<value_type>,
+                      "a slot cannot be released again once it is claimed, so moving an element out of the ring buffer must not throw");
+
+    private:
+        enum struct op_result : uint8_t {
+            success,
+            would_block,
+            closed,
+        };
+
+        /**
+         * A single element of the ring buffer.
+         * turn_ encodes the state of the slot: it is even while the slot is empty and odd while it is occupied,
+         * turn_ / 2 is the number of times the ring buffer has wrapped around for this slot.
+         */
+        struct alignas(detail_channel::cache_line_size) slot {
+            std::atomic<size_t> turn_ = 0;
+            bool skip_ = false; ///< constructing the element threw, the slot is occupied but does not contain an element (published via turn_)
+            alignas(T) std::byte storage_[sizeof(T)];
+
+            T *value_ptr() noexcept {
+                return std::launder(reinterpret_cast<T *>(storage_));
+            }
+        };
+
+        static constexpr size_t closed_bit = size_t{1} << (sizeof(size_t) * 8 - 1); ///< set in head_ once the channel is closed
+
+        size_t max_cap_; ///< number of slots in ring_
+        std::unique_ptr<slot[]> ring_; ///< the ring buffer
+
+        alignas(detail_channel::cache_line_size) std::atomic<size_t> head_ = 0; ///< next position to write to, has closed_bit set once the channel is closed
+        alignas(detail_channel::cache_line_size) std::atomic<size_t> tail_ = 0; ///< next position to read from
+
+        // everything below is only touched if a thread needs to block
+        alignas(detail_channel::cache_line_size) std::mutex park_mutex_; ///< mutex for queue_not_empty_ and queue_not_full_
+        detail_channel::channel_parking_spot<instrumentation, WaitPolicy> queue_not_empty_; ///< consumers wait for "there is an element in ring_ or the channel is closed"
+        detail_channel::channel_parking_spot<instrumentation, WaitPolicy> queue_not_full_; ///< producers wait for "there is a free slot in ring_ or the channel is closed"
+        [[no_unique_address]] detail_channel::channel_counters<instrumentation> counters_; ///< statistics, empty if instrumentation is disabled
+        detail_channel::select_waiter_list select_waiters_; ///< threads in select() waiting for this channel
+
+        friend struct detail_channel::select_access;
+
+        [[nodiscard]] slot &slot_at(size_t pos) noexcept {
+            return ring_[pos % max_cap_];
+        }
+
+        [[nodiscard]] size_t turn_at(size_t pos) const noexcept {
+            return pos / max_cap_;
+        }
+
+        template<typename ...Args>
+        op_result try_emplace_impl(Args &&...args) noexcept(std::is_nothrow_constructible_v<value_type, decltype(std::forward<Args>(args))...>) {
+            auto head = head_.load(std::memory_order_acquire);
+
+            while (true) {
+                if (head & closed_bit) [[unlikely]] {
+                    return op_result::closed;
+                }
+
+                auto &s = slot_at(head);
+                if (s.turn_.load(std::memory_order_acquire) == 2 * turn_at(head)) {
+                    // slot is free, try to claim it
+                    // note: this fails if the channel was closed in the meantime, because that modifies head_
+                    if (head_.compare_exchange_strong(head, head + 1, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                        if constexpr (std::is_nothrow_constructible_v<value_type, decltype(std::forward<Args>(args))...>) {
+                            new (s.storage_) T(std::forward<Args>(args)...);
+                        } else {
+                            try {
+                                new (s.storage_) T(std::forward<Args>(args)...);
+                            } catch (...) {
+                                // the slot is claimed and must be published, otherwise it blocks the channel forever
+                                s.skip_ = true;
+                                s.turn_.store(2 * turn_at(head) + 1, std::memory_order_release);
+                                queue_not_empty_.unpark(park_mutex_); // a consumer needs to release the slot
+                                throw;
+                            }
+                        }
+                        s.turn_.store(2 * turn_at(head) + 1, std::memory_order_release);
+
+                        if constexpr (instrumentation == channel_instrumentation::enabled) {
+                            // approximate, tail_ might have moved in the meantime
+                            auto const tail = tail_.load(std::memory_order_relaxed);
+                            counters_.add_pushed(1, head + 1 > tail ? head + 1 - tail : 0);
+                        }
+                        return op_result::success;
+                    }
+                } else {
+                    auto const prev_head = head;
+                    head = head_.load(std::memory_order_acquire);
+                    if (head == prev_head) {
+                        // slot is still occupied by the previous round, the ring is full
+                        return op_result::would_block;
+                    }
+                }
+            }
+        }
+
+        std::optional<value_type> try_pop_impl() noexcept {
+            auto tail = tail_.load(std::memory_order_acquire);
+
+            while (true) {
+                auto &s = slot_at(tail);
+                if (s.turn_.load(std::memory_order_acquire) == 2 * turn_at(tail) + 1) {
+                    // slot is occupied, try to claim it
+                    if (tail_.compare_exchange_strong(tail, tail + 1, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                        if (s.skip_) [[unlikely]] {
+                            // constructing the element threw, release the slot and continue with the next one
+                            s.skip_ = false;
+                            s.turn_.store(2 * turn_at(tail) + 2, std::memory_order_release);
+                            queue_not_full_.unpark(park_mutex_);
+                            ++tail;
+                            continue;
+                        }
+
+                        std::optional<value_type> ret{std::move(*s.value_ptr())};
+                        s.value_ptr()->~T();
+                        s.turn_.store(2 * turn_at(tail) + 2, std::memory_order_release);
+                        counters_.add_popped(1);
+                        return ret;
+                    }
+                } else {
+                    auto const prev_tail = tail;
+                    tail = tail_.load(std::memory_order_acquire);
+                    if (tail == prev_tail) {
+                        // slot was not yet written to in this round, the ring is empty
+                        return std::nullopt;
+                    }
+                }
+            }
+        }
 
-namespace dice::template_library {
+        /**
+         * Pushes elements from [it, end) until the range is exhausted or an element could not be pushed.
+         * @return number of pushed elements and the result of the last push attempt
+         */
+        template<typename Iter, typename Sent>
+        std::pair<size_t, op_result> try_push_some(Iter &it, Sent const &end) noexcept(std::is_nothrow_constructible_v<value_type, std::iter_reference_t<Iter>>) {
+            size_t n = 0;
+            for (; it != end; ++it, ++n) {
+                if (auto const res = try_emplace_impl(*it); res != op_result::success) {
+                    return {n, res};
+                }
+            }
+            return {n, op_result::success};
+        }
 
-	/**
-     * A multi producer, multi consumer channel/queue
-     * @warning close() must be called once the producing threads are done, otherwise the reading thread will hang indefinitely
-     *
-     * @tparam T value type of the channel
-     */
-    template<typename T>
-    struct channel {
-        using value_type = T;
-        using size_type = size_t;
-        using difference_type = std::ptrdiff_t;
-        using reference = value_type &;
-        using const_reference = value_type const &;
-        using pointer = T *;
-        using const_pointer = T const *;
+        /**
+         * Wake up the threads waiting for n new elements in ring_
+         */
+        void notify_not_empty(size_t n) noexcept {
+            queue_not_empty_.unpark(park_mutex_, n);
+            if (n > 0) {
+                select_waiters_.notify_all();
+            }
+        }
 
-    private:
-        size_t max_cap_; ///< maximum allowed number of elements in queue_
-        std::deque<T> queue_; ///< queue for elements
+        /**
+         * @return true if there is at least one free slot or the channel is closed
+         */
+        [[nodiscard]] bool writable_or_closed() noexcept {
+            auto const head = head_.load(std::memory_order_acquire);
+            return (head & closed_bit) || slot_at(head).turn_.load(std::memory_order_acquire) == 2 * turn_at(head);
+        }
 
-        std::atomic_flag closed_ = ATOMIC_FLAG_INIT; ///< true if this channel is closed
-        std::mutex queue_mutex_; ///< mutex for queue_
-        std::condition_variable queue_not_empty_; ///< condvar for queue_.size() > 0
-        std::condition_variable queue_not_full_;  ///< condvar for queue_.size() < max_cap_;
+        /**
+         * @return true if there is at least one readable element or the channel is closed and all elements were consumed
+         */
+        [[nodiscard]] bool readable_or_drained() noexcept {
+            auto const tail = tail_.load(std::memory_order_acquire);
+            if (slot_at(tail).turn_.load(std::memory_order_acquire) == 2 * turn_at(tail) + 1) {
+                return true;
+            }
+
+            auto const head = head_.load(std::memory_order_acquire);
+            return (head & closed_bit) && (head & ~closed_bit) == tail;
+        }
 
     public:
+        /**
+         * @param capacity number of elements the channel can hold, must be greater than 0
+         * @throws std::invalid_argument if capacity is 0
+         */
         explicit channel(size_t capacity) : max_cap_{capacity} {
-            // note: for some reason std::deque does not have .reserve()
-            // TODO: it would probably make sense to implement a VecDeque for this (https://doc.rust-lang.org/std/collections/struct.VecDeque.html)
+            if (capacity == 0) [[unlikely]] {
+                throw std::invalid_argument{"channel::channel: a lock_free_ring channel needs a capacity greater than 0"};
+            }
+            ring_ = std::make_unique<slot[]>(capacity);
         }
 
         // there is no way to safely implement these with concurrent access
@@ -48,34 +1942,53 @@ namespace dice::template_library {
         channel &operator=(channel const &other) = delete;
         channel &operator=(channel &&other) noexcept = delete;
 
-        ~channel() noexcept = default;
+        ~channel() noexcept {
+            auto const head = head_.load(std::memory_order_relaxed) & ~closed_bit;
+            for (auto pos = tail_.load(std::memory_order_relaxed); pos != head; ++pos) {
+                if (auto &s = slot_at(pos); !s.skip_) {
+                    s.value_ptr()->~T();
+                }
+            }
+        }
 
-		/**
+        /**
          * Close the channel.
          * After calling close calls to push() will return false
          * and calls to try_pop will return std::nullopt once the already present elements are exhausted
          */
         void close() noexcept {
-            {
-                // "Even if the shared variable is atomic, it must be modified while owning the mutex to correctly publish the modification to the waiting thread."
-                // - https://en.cppreference.com/w/cpp/thread/condition_variable
-                //
-                // Here closed_ is the shared variable used by queue_not_empty_ in another thread (the one waiting in try_pop)
-                std::lock_guard lock{queue_mutex_};
-                closed_.test_and_set(std::memory_order_release);
-            }
-            queue_not_empty_.notify_all(); // notify pop() so that it does not get stuck
-            queue_not_full_.notify_all(); // notify emplace()
+            head_.fetch_or(closed_bit, std::memory_order_seq_cst);
+            queue_not_empty_.unpark_all(park_mutex_); // notify pop() so that it does not get stuck
+            queue_not_full_.unpark_all(park_mutex_); // notify emplace()
+            select_waiters_.notify_all(); // notify select()
         }
 
-		/**
+        /**
          * @return true if this channel is closed
          */
         [[nodiscard]] bool closed() const noexcept {
-            return closed_.test(std::memory_order_acquire);
+            return head_.load(std::memory_order_acquire) & closed_bit;
         }
 
-		/**
+        /**
+         * @return true if this channel is closed and all elements were consumed, i.e. no element will ever be available again
+         */
+        [[nodiscard]] bool drained() const noexcept {
+            auto const head = head_.load(std::memory_order_acquire);
+            return (head & closed_bit) && (head & ~closed_bit) == tail_.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @return a snapshot of the statistics of this channel
+         */
+        [[nodiscard]] channel_stats stats() const noexcept requires (instrumentation == channel_instrumentation::enabled) {
+            auto ret = counters_.snapshot();
+            ret.push_wait_time = queue_not_full_.blocked_time();
+            ret.pop_wait_time = queue_not_empty_.blocked_time();
+            return ret;
+        }
+
+        /**
          * Emplace an element into the channel, blocks if there is no capacity left in the channel.
          *
          * @param args constructor args
@@ -83,25 +1996,22 @@ namespace dice::template_library {
          */
         template<typename ...Args>
         bool emplace(Args &&...args) noexcept(std::is_nothrow_constructible_v<value_type, decltype(std::forward<Args>(args))...>) {
-            if (closed_.test(std::memory_order_acquire)) [[unlikely]] {
-                return false;
-            }
-
-            {
-                std::unique_lock lock{queue_mutex_};
-                queue_not_full_.wait(lock, [this]() noexcept { return queue_.size() < max_cap_ || closed_.test(std::memory_order_relaxed); });
-
-                if (closed_.test(std::memory_order_relaxed)) [[unlikely]] {
-                    // relaxed is enough because we hold the lock
-                    // wait was exited because closed_ was true (channel closed)
-                    return false;
+            while (true) {
+                // note: args are only consumed if try_emplace_impl succeeds, so it is fine to forward them in a loop
+                switch (try_emplace_impl(std::forward<Args>(args)...)) {
+                    case op_result::success: {
+                        notify_not_empty(1);
+                        return true;
+                    }
+                    case op_result::closed: {
+                        return false;
+                    }
+                    case op_result::would_block: {
+                        queue_not_full_.park(park_mutex_, [this]() noexcept { return writable_or_closed(); });
+                        break;
+                    }
                 }
-
-                queue_.emplace_back(std::forward<Args>(args)...);
             }
-
-            queue_not_empty_.notify_one();
-            return true;
         }
 
         /**
@@ -112,25 +2022,15 @@ namespace dice::template_library {
          */
         template<typename ...Args>
         bool try_emplace(Args &&...args) noexcept(std::is_nothrow_constructible_v<value_type, decltype(std::forward<Args>(args))...>) {
-            if (closed_.test(std::memory_order_acquire)) [[unlikely]] {
+            if (try_emplace_impl(std::forward<Args>(args)...) != op_result::success) {
                 return false;
             }
 
-            {
-                std::unique_lock lock{queue_mutex_};
-                if (queue_.size() >= max_cap_ || closed_.test(std::memory_order_relaxed)) {
-                    // relaxed is enough because we hold the lock
-                    return false;
-                }
-
-                queue_.emplace_back(std::forward<Args>(args)...);
-            }
-
-            queue_not_empty_.notify_one();
+            notify_not_empty(1);
             return true;
         }
 
-		/**
+        /**
          * Push a single element into the channel, blocks if there is no capacity left in the channel.
          *
          * @param value the element to push
@@ -170,130 +2070,273 @@ namespace dice::template_library {
             return try_emplace(std::move(value));
         }
 
-		/**
-         * Try to get a (previously pushed) element from the channel.
-         * If there is no element available, blocks until there is one available or the channel is closed.
+        /**
+         * Emplace an element into the channel, blocks until deadline if there is no capacity left in the channel.
          *
-         * @return std::nullopt if the channel was closed, an element otherwise
+         * @param deadline point in time after which to give up
+         * @param args constructor args
+         * @return nothing on success, channel_error::closed if the channel is closed or channel_error::timeout if there was no capacity until deadline
          */
-        [[nodiscard]] std::optional<value_type> pop() noexcept(std::is_nothrow_move_constructible_v<value_type>) {
-            std::unique_lock lock{queue_mutex_};
-            queue_not_empty_.wait(lock, [this]() noexcept { return !queue_.empty() || closed_.test(std::memory_order_relaxed); });
-
-            if (queue_.empty()) [[unlikely]] {
-                // implies closed_ == true
-                return std::nullopt;
+        template<typename Clock, typename Duration, typename ...Args>
+        std::expected<void, channel_error> emplace_until(std::chrono::time_point<Clock, Duration> const &deadline, Args &&...args) noexcept(std::is_nothrow_constructible_v<value_type, decltype(std::forward<Args>(args))...>) {
+            while (true) {
+                // note: args are only consumed if try_emplace_impl succeeds, so it is fine to forward them in a loop
+                switch (try_emplace_impl(std::forward<Args>(args)...)) {
+                    case op_result::success: {
+                        notify_not_empty(1);
+                        return {};
+                    }
+                    case op_result::closed: {
+                        return std::unexpected{channel_error::closed};
+                    }
+                    case op_result::would_block: {
+                        if (!queue_not_full_.park_until(park_mutex_, deadline, [this]() noexcept { return writable_or_closed(); })) {
+                            return std::unexpected{channel_error::timeout};
+                        }
+                        break;
+                    }
+                }
             }
+        }
 
-            auto ret = std::move(queue_.front());
-            queue_.pop_front();
+        /**
+         * Emplace an element into the channel, blocks for at most timeout if there is no capacity left in the channel.
+         *
+         * @param timeout maximum duration to wait for capacity
+         * @param args constructor args
+         * @return nothing on success, channel_error::closed if the channel is closed or channel_error::timeout if there was no capacity in time
+         */
+        template<typename Rep, typename Period, typename ...Args>
+        std::expected<void, channel_error> emplace_for(std::chrono::duration<Rep, Period> const &timeout, Args &&...args) noexcept(std::is_nothrow_constructible_v<value_type, decltype(std::forward<Args>(args))...>) {
+            return emplace_until(std::chrono::steady_clock::now() + timeout, std::forward<Args>(args)...);
+        }
 
-			lock.unlock();
-            queue_not_full_.notify_one();
-            return ret;
+        /**
+         * Push a single element into the channel, blocks until deadline if there is no capacity left in the channel.
+         *
+         * @param value the element to push
+         * @param deadline point in time after which to give up
+         * @return nothing on success, channel_error::closed if the channel is closed or channel_error::timeout if there was no capacity until deadline
+         */
+        template<typename Clock, typename Duration>
+        std::expected<void, channel_error> push_until(value_type const &value, std::chrono::time_point<Clock, Duration> const &deadline) noexcept(std::is_nothrow_copy_constructible_v<value_type>) {
+            return emplace_until(deadline, value);
         }
 
         /**
-         * Try to get a (previously pushed) element from the channel.
-         * Unlike pop(), if there is no element available, returns std::nullopt immediatly.
+         * Push a single element into the channel, blocks until deadline if there is no capacity left in the channel.
+         *
+         * @param value the element to push
+         * @param deadline point in time after which to give up
+         * @return nothing on success, channel_error::closed if the channel is closed or channel_error::timeout if there was no capacity until deadline
          */
-        [[nodiscard]] std::optional<value_type> try_pop() noexcept(std::is_nothrow_move_constructible_v<value_type>) {
-            std::unique_lock lock{queue_mutex_};
-            if (queue_.empty()) {
-                return std::nullopt;
-            }
+        template<typename Clock, typename Duration>
+        std::expected<void, channel_error> push_until(value_type &&value, std::chrono::time_point<Clock, Duration> const &deadline) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            return emplace_until(deadline, std::move(value));
+        }
 
-            auto ret = std::move(queue_.front());
-            queue_.pop_front();
+        /**
+         * Push a single element into the channel, blocks for at most timeout if there is no capacity left in the channel.
+         *
+         * @param value the element to push
+         * @param timeout maximum duration to wait for capacity
+         * @return nothing on success, channel_error::closed if the channel is closed or channel_error::timeout if there was no capacity in time
+         */
+        template<typename Rep, typename Period>
+        std::expected<void, channel_error> push_for(value_type const &value, std::chrono::duration<Rep, Period> const &timeout) noexcept(std::is_nothrow_copy_constructible_v<value_type>) {
+            return emplace_for(timeout, value);
+        }
 
-            lock.unlock();
-            queue_not_full_.notify_one();
-            return ret;
+        /**
+         * Push a single element into the channel, blocks for at most timeout if there is no capacity left in the channel.
+         *
+         * @param value the element to push
+         * @param timeout maximum duration to wait for capacity
+         * @return nothing on success, channel_error::closed if the channel is closed or channel_error::timeout if there was no capacity in time
+         */
+        template<typename Rep, typename Period>
+        std::expected<void, channel_error> push_for(value_type &&value, std::chrono::duration<Rep, Period> const &timeout) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            return emplace_for(timeout, std::move(value));
         }
 
-        struct iterator {
-            using channel_type = channel;
-            using value_type = T;
-            using difference_type = std::ptrdiff_t;
-            using reference = T &;
-            using const_reference = T const &;
-            using pointer = typename channel_type::pointer;
-            using const_pointer = typename channel_type::const_pointer;
-            using iterator_category = std::input_iterator_tag;
+        /**
+         * Push all elements of a range into the channel.
+         * Blocks while there is no capacity left in the channel. Every time capacity becomes available
+         * as many elements as fit are pushed, followed by a single notification.
+         *
+         * @param range the elements to push, elements are constructed from `*it` (wrap the range in `std::views::as_rvalue` to move them)
+         * @return the number of elements pushed. This is less than the size of range only if the channel was closed.
+         */
+        template<std::ranges::input_range R>
+        size_t push_range(R &&range) noexcept(std::is_nothrow_constructible_v<value_type, std::ranges::range_reference_t<R>>) {
+            auto it = std::ranges::begin(range);
+            auto const end = std::ranges::end(range);
 
-        private:
-            channel_type *chan_;
-            mutable std::optional<value_type> buf_; ///< this has to be mutable for this iterator to fullfill std::input_iterator
+            size_t n_pushed = 0;
+            while (it != end) {
+                auto const [n_batch, res] = try_push_some(it, end);
+                notify_not_empty(n_batch);
+                n_pushed += n_batch;
 
-            void advance() noexcept {
-                buf_ = chan_->pop();
-            }
+                if (res == op_result::closed) [[unlikely]] {
+                    break;
+                }
 
-        public:
-            explicit iterator(channel_type *chan) noexcept : chan_{chan} {
-                advance();
+                if (res == op_result::would_block) {
+                    queue_not_full_.park(park_mutex_, [this]() noexcept { return writable_or_closed(); });
+                }
             }
 
-            iterator(iterator const &other) noexcept(std::is_nothrow_copy_constructible_v<value_type>)
-                : chan_{other.chan_},
-                  buf_{other.buf_} {
-            }
+            return n_pushed;
+        }
 
-            iterator &operator=(iterator const &other) noexcept(std::is_nothrow_copy_assignable_v<value_type>) {
-                if (this == &other) {
-                    return *this;
+        /**
+         * Push as many elements of a range into the channel as there is capacity for, returns immediately if there is no capacity in the channel.
+         * All elements are pushed before a single notification is issued.
+         *
+         * @param range the elements to push, elements are constructed from `*it` (wrap the range in `std::views::as_rvalue` to move them)
+         * @return the number of elements pushed
+         */
+        template<std::ranges::input_range R>
+        size_t try_push_range(R &&range) noexcept(std::is_nothrow_constructible_v<value_type, std::ranges::range_reference_t<R>>) {
+            auto it = std::ranges::begin(range);
+            auto const n_pushed = try_push_some(it, std::ranges::end(range)).first;
+            notify_not_empty(n_pushed);
+            return n_pushed;
+        }
+
+        /**
+         * Try to get a (previously pushed) element from the channel.
+         * If there is no element available, blocks until there is one available or the channel is closed.
+         *
+         * @return std::nullopt if the channel was closed, an element otherwise
+         */
+        [[nodiscard]] std::optional<value_type> pop() noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            while (true) {
+                if (auto ret = try_pop_impl(); ret.has_value()) {
+                    queue_not_full_.unpark(park_mutex_);
+                    return ret;
                 }
 
-                chan_ = other.chan_;
-                buf_ = other.buf_;
-                return *this;
-            }
+                auto const head = head_.load(std::memory_order_acquire);
+                if ((head & closed_bit) && (head & ~closed_bit) == tail_.load(std::memory_order_acquire)) [[unlikely]] {
+                    // closed and all elements were consumed
+                    return std::nullopt;
+                }
 
-            iterator(iterator &&other) noexcept(std::is_nothrow_move_constructible_v<value_type>)
-                : chan_{other.chan_},
-                  buf_{std::move(other.buf_)} {
+                queue_not_empty_.park(park_mutex_, [this]() noexcept { return readable_or_drained(); });
             }
+        }
 
-            iterator &operator=(iterator &&other) noexcept(std::is_nothrow_swappable_v<value_type>) {
-                assert(this != &other);
-                std::swap(chan_, other.chan_);
-                std::swap(buf_, other.buf_);
-                return *this;
+        /**
+         * Try to get a (previously pushed) element from the channel.
+         * Unlike pop(), if there is no element available, returns std::nullopt immediatly.
+         */
+        [[nodiscard]] std::optional<value_type> try_pop() noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            auto ret = try_pop_impl();
+            if (ret.has_value()) {
+                queue_not_full_.unpark(park_mutex_);
             }
+            return ret;
+        }
 
-            reference operator*() noexcept {
-                return *buf_;
-            }
+        /**
+         * Try to get a (previously pushed) element from the channel.
+         * If there is no element available, blocks until there is one available, the channel is closed or deadline has passed.
+         *
+         * @param deadline point in time after which to give up
+         * @return an element, or channel_error::closed if the channel was closed or channel_error::timeout if there was no element until deadline
+         */
+        template<typename Clock, typename Duration>
+        [[nodiscard]] std::expected<value_type, channel_error> pop_until(std::chrono::time_point<Clock, Duration> const &deadline) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            while (true) {
+                if (auto ret = try_pop_impl(); ret.has_value()) {
+                    queue_not_full_.unpark(park_mutex_);
+                    return std::move(*ret);
+                }
 
-            reference operator*() const noexcept {
-                return *buf_;
-            }
+                auto const head = head_.load(std::memory_order_acquire);
+                if ((head & closed_bit) && (head & ~closed_bit) == tail_.load(std::memory_order_acquire)) [[unlikely]] {
+                    // closed and all elements were consumed
+                    return std::unexpected{channel_error::closed};
+                }
 
-            pointer operator->() noexcept {
-                return &*buf_;
+                if (!queue_not_empty_.park_until(park_mutex_, deadline, [this]() noexcept { return readable_or_drained(); })) {
+                    return std::unexpected{channel_error::timeout};
+                }
             }
+        }
 
-            pointer operator->() const noexcept {
-                return &*buf_;
-            }
+        /**
+         * Try to get a (previously pushed) element from the channel.
+         * If there is no element available, blocks until there is one available, the channel is closed or timeout has elapsed.
+         *
+         * @param timeout maximum duration to wait for an element
+         * @return an element, or channel_error::closed if the channel was closed or channel_error::timeout if there was no element in time
+         */
+        template<typename Rep, typename Period>
+        [[nodiscard]] std::expected<value_type, channel_error> pop_for(std::chrono::duration<Rep, Period> const &timeout) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            return pop_until(std::chrono::steady_clock::now() + timeout);
+        }
 
-            iterator &operator++() noexcept {
-                advance();
-                return *this;
-            }
+        /**
+         * Get up to max_batch_size (previously pushed) elements from the channel.
+         * If there is no element available, blocks until there is at least one available or the channel is closed.
+         * A single notification is issued after all elements were removed.
+         *
+         * @param out output iterator the elements are moved to
+         * @param max_batch_size maximum number of elements to get, must be greater than 0
+         * @return the number of elements written to out, 0 if the channel was closed
+         */
+        template<std::output_iterator<value_type &&> OutputIt>
+        size_t pop_batch(OutputIt out, size_t max_batch_size) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            assert(max_batch_size > 0);
 
-            void operator++(int) noexcept {
-                advance();
+            while (true) {
+                if (auto const n = try_pop_batch(out, max_batch_size); n > 0) {
+                    return n;
+                }
+
+                auto const head = head_.load(std::memory_order_acquire);
+                if ((head & closed_bit) && (head & ~closed_bit) == tail_.load(std::memory_order_acquire)) [[unlikely]] {
+                    // closed and all elements were consumed
+                    return 0;
+                }
+
+                queue_not_empty_.park(park_mutex_, [this]() noexcept { return readable_or_drained(); });
             }
+        }
 
-            bool operator==(std::default_sentinel_t) const noexcept {
-                return !buf_.has_value();
+        /**
+         * Get up to max_batch_size (previously pushed) elements from the channel.
+         * Unlike pop_batch(), if there is no element available, returns 0 immediately.
+         *
+         * @param out output iterator the elements are moved to
+         * @param max_batch_size maximum number of elements to get
+         * @return the number of elements written to out
+         */
+        template<std::output_iterator<value_type &&> OutputIt>
+        size_t try_pop_batch(OutputIt out, size_t max_batch_size) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            size_t n = 0;
+            for (; n < max_batch_size; ++n) {
+                auto elem = try_pop_impl();
+                if (!elem.has_value()) {
+                    break;
+                }
+
+                *out = std::move(*elem);
+                ++out;
             }
-        };
 
+            queue_not_full_.unpark(park_mutex_, n);
+            return n;
+        }
+
+        using iterator = detail_channel::channel_iterator<channel>;
+        using batched_view = detail_channel::batched_channel_view<channel>;
         using sentinel = std::default_sentinel_t;
 
-		/**
+        /**
          * @return an iterator over all present and future elements of this channel
          * @note iterator == end() is true once the channel is closed
          */
@@ -304,6 +2347,16 @@ namespace dice::template_library {
         [[nodiscard]] sentinel end() const noexcept {
             return std::default_sentinel;
         }
+
+        /**
+         * @param max_batch_size maximum number of elements that are removed from the channel at once, must be greater than 0
+         * @return a range over all present and future elements of this channel, that removes elements from the channel in batches (see pop_batch)
+         * @note like begin()/end(), the range ends once the channel is closed
+         * @warning elements that were removed from the channel but not yet reached by the iteration are lost if the iteration is stopped early
+         */
+        [[nodiscard]] batched_view batched(size_t max_batch_size) noexcept {
+            return batched_view{this, max_batch_size};
+        }
     };
 
 } // namespace dice::template_library
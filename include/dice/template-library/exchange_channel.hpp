@@ -1,10 +1,16 @@
 #ifndef DICE_TEMPLATELIBRARY_EXCHANGECHANNEL_HPP
 #define DICE_TEMPLATELIBRARY_EXCHANGECHANNEL_HPP
 
+#include <dice/template-library/channel.hpp>
+
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <condition_variable>
+#include <coroutine>
 #include <cstddef>
+#include <expected>
+#include <functional>
 #include <iterator>
 #include <mutex>
 #include <optional>
@@ -13,11 +19,43 @@
 
 namespace dice::template_library {
 
+    /**
+     * Default merge function of exchange_channel: the new value replaces the current one, i.e. the current one is dropped.
+     * exchange_channel does not actually call this, it destroys the current value and constructs the new one in its place,
+     * so value types do not need to be assignable.
+     */
+    struct exchange_overwrite {
+        template<typename T>
+        void operator()(T &current, T &&incoming) const noexcept(std::is_nothrow_move_assignable_v<T>) {
+            current = std::move(incoming);
+        }
+    };
+
+    /**
+     * A function that combines the current (unconsumed) value of an exchange_channel with a newly pushed one.
+     * It either updates current in place (returning void), like `[](auto &current, auto &&incoming) { current += incoming; }`,
+     * or returns the combined value, like std::plus<>.
+     */
+    template<typename Merge, typename T>
+    concept exchange_merge_function = std::invocable<Merge &, T &, T &&>
+                                      && (std::is_void_v<std::invoke_result_t<Merge &, T &, T &&>>
+                                          || std::is_invocable_r_v<T, Merge &, T &&, T &&>);
+
     /**
      * A multi producer, multi consumer channel
      * that only retains the last sent value.
+     * For a single producer and single consumer exchanging large values, see triple_buffer,
+     * which neither locks nor constructs a value per exchange.
+     *
+     * @tparam T value type of the channel
+     * @tparam instrumentation whether the channel collects statistics, see channel_stats
+     * @tparam WaitPolicy how threads wait before they block, see park_wait_policy, spin_wait_policy and adaptive_wait_policy
+     * @tparam Merge how a pushed value is combined with the current value if that was not consumed yet, see exchange_merge_function.
+     *         By default (exchange_overwrite) the current value is replaced, a merge function like std::plus<> instead accumulates
+     *         all values pushed since the last pop, so that no update is lost.
      */
-    template<typename T>
+    template<typename T, channel_instrumentation instrumentation = channel_instrumentation::disabled, typename WaitPolicy = adaptive_wait_policy<>,
+             exchange_merge_function<T> Merge = exchange_overwrite>
     struct exchange_channel {
         using value_type = T;
         using size_type = size_t;
@@ -32,11 +70,75 @@ namespace dice::template_library {
         std::optional<T> value_;  ///< the last value that was sent
 
         std::atomic_flag closed_ = ATOMIC_FLAG_INIT;  ///< true if this channel is closed
-        std::condition_variable has_value_;           ///< condvar for value_.has_value()
+        detail_channel::channel_condition_variable<instrumentation, WaitPolicy> has_value_;  ///< condvar for value_.has_value()
+        [[no_unique_address]] detail_channel::channel_counters<instrumentation> counters_;  ///< statistics, empty if instrumentation is disabled
+        detail_channel::select_waiter_list select_waiters_;  ///< threads in select() waiting for this channel
+        detail_channel::co_waiter_queue co_pop_waiters_;     ///< coroutines suspended in co_pop(), can only be non-empty if value_ is empty
+        [[no_unique_address]] Merge merge_;                  ///< combines value_ with newly pushed values
+
+        static constexpr bool overwrites = std::is_same_v<Merge, exchange_overwrite>;
+        static constexpr bool merges_in_place = std::is_void_v<std::invoke_result_t<Merge &, value_type &, value_type &&>>;
+        static constexpr bool nothrow_merge = overwrites  // overwriting destroys the current value and constructs the new one in place
+                                              || ((merges_in_place ? std::is_nothrow_invocable_v<Merge &, value_type &, value_type &&>
+                                                                   : std::is_nothrow_invocable_r_v<value_type, Merge &, value_type &&, value_type &&>)
+                                                  && std::is_nothrow_move_constructible_v<value_type>
+                                                  && std::is_nothrow_move_assignable_v<value_type>);
+
+        friend struct detail_channel::select_access;
+
+        template<typename Channel, typename Executor>
+        friend struct detail_channel::co_pop_awaiter;
+
+        /**
+         * Remove the current value from the channel.
+         * @pre value_mutex_ is held and value_.has_value()
+         */
+        value_type take_value() noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            counters_.add_popped(1);
+            return *std::exchange(value_, std::nullopt);
+        }
+
+        /**
+         * Combine value_ with a newly pushed value using a user-supplied merge function.
+         * @pre value_mutex_ is held and value_.has_value()
+         */
+        void merge_value(value_type &&incoming) noexcept(nothrow_merge) requires (!overwrites) {
+            if constexpr (merges_in_place) {
+                std::invoke(merge_, *value_, std::move(incoming));
+            } else {
+                *value_ = std::invoke(merge_, std::move(*value_), std::move(incoming));
+            }
+        }
+
+        /**
+         * Called by co_pop_awaiter::await_suspend
+         * @return true if the coroutine needs to be suspended
+         */
+        bool co_pop_suspend(detail_channel::co_pop_waiter<value_type> &waiter) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            std::unique_lock lock{value_mutex_};
+            if (value_.has_value()) {
+                waiter.elem_.emplace(take_value());
+                return false;
+            }
+
+            if (closed_.test(std::memory_order_relaxed)) [[unlikely]] {
+                // relaxed is enough because we hold the lock
+                return false;
+            }
+
+            co_pop_waiters_.push_back(waiter);
+            return true;
+        }
 
     public:
         exchange_channel() = default;
 
+        /**
+         * @param merge function to combine the current value with newly pushed values
+         */
+        explicit exchange_channel(Merge merge) noexcept(std::is_nothrow_move_constructible_v<Merge>) : merge_{std::move(merge)} {
+        }
+
         // there is no way to safely implement these with concurrent access
         exchange_channel(exchange_channel const &other) = delete;
         exchange_channel(exchange_channel &&other) = delete;
@@ -51,6 +153,8 @@ namespace dice::template_library {
          * and calls to try_pop will return std::nullopt once the already present elements are exhausted
          */
         void close() noexcept {
+            detail_channel::co_waiter_queue ready;
+
             {
                 // "Even if the shared variable is atomic, it must be modified while owning the mutex to correctly publish the modification to the waiting thread."
                 // - https://en.cppreference.com/w/cpp/thread/condition_variable
@@ -58,8 +162,11 @@ namespace dice::template_library {
                 // Here closed_ is the shared variable used by has_value_ in another thread (the one waiting in pop)
                 std::lock_guard lock{value_mutex_};
                 closed_.test_and_set(std::memory_order_release);
+                ready.append(co_pop_waiters_);  // suspended co_pop()s fail
             }
             has_value_.notify_all();  // notify pop() so that it does not get stuck
+            select_waiters_.notify_all();  // notify select()
+            ready.schedule_all();  // resume co_pop()
         }
 
         /**
@@ -70,17 +177,40 @@ namespace dice::template_library {
         }
 
         /**
-         * Emplace an element into the channel, replaces the current element in the channel if there is one.
+         * @return true if this channel is closed and the last value was consumed, i.e. no value will ever be available again
+         */
+        [[nodiscard]] bool drained() noexcept {
+            if (!closed_.test(std::memory_order_acquire)) {
+                return false;
+            }
+
+            std::lock_guard lock{value_mutex_};
+            return !value_.has_value();
+        }
+
+        /**
+         * @return a snapshot of the statistics of this channel
+         */
+        [[nodiscard]] channel_stats stats() const noexcept requires (instrumentation == channel_instrumentation::enabled) {
+            auto ret = counters_.snapshot();
+            ret.pop_wait_time = has_value_.blocked_time();
+            return ret;
+        }
+
+        /**
+         * Emplace an element into the channel, merges it with (by default: replaces) the current element in the channel if there is one.
          *
          * @param args constructor args
          * @return true if emplacing the element succeeded because the channel is not yet closed
          */
         template<typename... Args>
-        bool emplace(Args &&...args) noexcept(std::is_nothrow_constructible_v<value_type, decltype(std::forward<Args>(args))...>) {
+        bool emplace(Args &&...args) noexcept(std::is_nothrow_constructible_v<value_type, decltype(std::forward<Args>(args))...> && nothrow_merge) {
             if (closed_.test(std::memory_order_acquire)) [[unlikely]] {
                 return false;
             }
 
+            detail_channel::co_waiter_queue ready;
+
             {
                 std::unique_lock lock{value_mutex_};
                 if (closed_.test(std::memory_order_relaxed)) [[unlikely]] {
@@ -88,30 +218,49 @@ namespace dice::template_library {
                     return false;
                 }
 
-                value_.emplace(std::forward<Args>(args)...);
+                if (!co_pop_waiters_.empty()) [[unlikely]] {
+                    // hand the value directly to a suspended co_pop()
+                    auto &waiter = static_cast<detail_channel::co_pop_waiter<value_type> &>(co_pop_waiters_.pop_front());
+                    waiter.elem_.emplace(std::forward<Args>(args)...);
+                    ready.push_back(waiter);
+                    counters_.add_popped(1);
+                } else if constexpr (overwrites) {
+                    if (value_.has_value()) {
+                        // the previous value was never popped
+                        counters_.add_dropped(1);
+                    }
+                    value_.emplace(std::forward<Args>(args)...);
+                } else if (value_.has_value()) {
+                    merge_value(value_type(std::forward<Args>(args)...));
+                } else {
+                    value_.emplace(std::forward<Args>(args)...);
+                }
+                counters_.add_pushed(1, 1);
             }
 
             has_value_.notify_one();
+            select_waiters_.notify_all();
+            ready.schedule_all();
             return true;
         }
 
         /**
-         * Push a single element into the channel, replaces the current element in the channel if there is one.
+         * Push a single element into the channel, merges it with (by default: replaces) the current element in the channel if there is one.
          *
          * @param value the element to push
          * @return true if pushing the element succeeded because the channel is not yet closed
          */
-        bool push(value_type const &value) noexcept(std::is_nothrow_copy_constructible_v<value_type>) {
+        bool push(value_type const &value) noexcept(std::is_nothrow_copy_constructible_v<value_type> && nothrow_merge) {
             return emplace(value);
         }
 
         /**
-         * Push a single element into the channel, replaces the current element in the channel if there is one.
+         * Push a single element into the channel, merges it with (by default: replaces) the current element in the channel if there is one.
          *
          * @param value the element to push
          * @return true if pushing the element succeeded because the channel is not yet closed
          */
-        bool push(value_type &&value) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+        bool push(value_type &&value) noexcept(std::is_nothrow_move_constructible_v<value_type> && nothrow_merge) {
             return emplace(std::move(value));
         }
 
@@ -132,7 +281,7 @@ namespace dice::template_library {
                 return std::nullopt;
             }
 
-            return *std::exchange(value_, std::nullopt);
+            return take_value();
         }
 
         /**
@@ -145,7 +294,84 @@ namespace dice::template_library {
                 return std::nullopt;
             }
 
-            return *std::exchange(value_, std::nullopt);
+            return take_value();
+        }
+
+        /**
+         * Try to get a (previously pushed) element from the channel.
+         * If there is no element available, blocks until there is one available, the channel is closed or deadline has passed.
+         *
+         * @param deadline point in time after which to give up
+         * @return an element, or channel_error::closed if the channel was closed or channel_error::timeout if there was no element until deadline
+         */
+        template<typename Clock, typename Duration>
+        [[nodiscard]] std::expected<value_type, channel_error> pop_until(std::chrono::time_point<Clock, Duration> const &deadline) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            std::unique_lock lock{value_mutex_};
+            if (!has_value_.wait_until(lock, deadline, [this]() noexcept { return value_.has_value() || closed_.test(std::memory_order_relaxed); })) {
+                return std::unexpected{channel_error::timeout};
+            }
+
+            if (!value_.has_value()) [[unlikely]] {
+                // implies closed_ == true
+                return std::unexpected{channel_error::closed};
+            }
+
+            return take_value();
+        }
+
+        /**
+         * Try to get a (previously pushed) element from the channel.
+         * If there is no element available, blocks until there is one available, the channel is closed or timeout has elapsed.
+         *
+         * @param timeout maximum duration to wait for an element
+         * @return an element, or channel_error::closed if the channel was closed or channel_error::timeout if there was no element in time
+         */
+        template<typename Rep, typename Period>
+        [[nodiscard]] std::expected<value_type, channel_error> pop_for(std::chrono::duration<Rep, Period> const &timeout) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            return pop_until(std::chrono::steady_clock::now() + timeout);
+        }
+
+        /**
+         * Get a (previously pushed) element from the channel without blocking the calling thread.
+         * If there is no element available, the awaiting coroutine is suspended until there is one available or the channel is closed.
+         * The element is then handed directly to the coroutine, which is resumed via executor.
+         *
+         * @param executor called with the handle of the suspended coroutine once it can be resumed, see channel_executor
+         * @return awaitable that results in std::nullopt if the channel was closed, an element otherwise
+         * @note if an element is available right away, the coroutine continues without being suspended
+         */
+        template<channel_executor Executor>
+        [[nodiscard]] detail_channel::co_pop_awaiter<exchange_channel, Executor> co_pop(Executor executor) noexcept(std::is_nothrow_move_constructible_v<Executor>) {
+            return detail_channel::co_pop_awaiter<exchange_channel, Executor>{*this, std::move(executor)};
+        }
+
+        /**
+         * Push a single element into the channel, merges it with (by default: replaces) the current element in the channel if there is one.
+         * Pushing into an exchange_channel never blocks, so the returned awaitable never suspends the awaiting coroutine,
+         * this only exists for symmetry with channel::co_push.
+         *
+         * @param value the element to push
+         * @return awaitable that results in true if pushing the element succeeded because the channel is not yet closed
+         */
+        template<channel_executor Executor>
+        [[nodiscard]] auto co_push(value_type value, [[maybe_unused]] Executor executor) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            struct awaiter {
+                exchange_channel *chan_;
+                value_type value_;
+
+                [[nodiscard]] bool await_ready() const noexcept {
+                    return true;
+                }
+
+                void await_suspend(std::coroutine_handle<>) const noexcept {
+                }
+
+                bool await_resume() noexcept(std::is_nothrow_move_constructible_v<value_type> && nothrow_merge) {
+                    return chan_->push(std::move(value_));
+                }
+            };
+
+            return awaiter{this, std::move(value)};
         }
 
         struct iterator {
@@ -0,0 +1,107 @@
+#ifndef DICE_TEMPLATELIBRARY_LOCKALL_HPP
+#define DICE_TEMPLATELIBRARY_LOCKALL_HPP
+
+#include <dice/template-library/mutex.hpp>
+#include <dice/template-library/shared_mutex.hpp>
+
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <utility>
+
+namespace dice::template_library {
+
+    namespace detail_lock_all {
+        /**
+         * Gives lock_all and try_lock_all access to the underlying mutex and value of mutex and shared_mutex
+         */
+        struct lock_access {
+            template<typename T, typename Mutex>
+            static Mutex &raw_mutex(mutex<T, Mutex> &mut) noexcept {
+                return mut.mutex_;
+            }
+
+            template<typename T, typename Mutex>
+            static Mutex &raw_mutex(shared_mutex<T, Mutex> &mut) noexcept {
+                return mut.mutex_;
+            }
+
+            /**
+             * @pre the underlying mutex of mut is locked exclusively by the calling thread
+             * @return a guard that takes over the lock
+             */
+            template<typename T, typename Mutex>
+            static mutex_guard<T, Mutex> adopt(mutex<T, Mutex> &mut) noexcept {
+                return mutex_guard<T, Mutex>{std::unique_lock<Mutex>{mut.mutex_, std::adopt_lock}, mut.value_};
+            }
+
+            /**
+             * @pre the underlying mutex of mut is locked exclusively by the calling thread
+             * @return a guard that takes over the lock
+             */
+            template<typename T, typename Mutex>
+            static shared_mutex_guard<T, Mutex> adopt(shared_mutex<T, Mutex> &mut) noexcept {
+                return shared_mutex_guard<T, Mutex>{std::unique_lock<Mutex>{mut.mutex_, std::adopt_lock}, mut.value_};
+            }
+        };
+
+        template<typename M>
+        concept value_mutex = requires (M &mut) {
+            lock_access::raw_mutex(mut);
+            lock_access::adopt(mut);
+        };
+
+        template<value_mutex M>
+        using guard_t = decltype(lock_access::adopt(std::declval<M &>()));
+    } // namespace detail_lock_all
+
+    /**
+     * Exclusively lock all given mutex/shared_mutex objects at once, without risking a deadlock with other threads that lock
+     * (some of) the same objects in a different order (using the same deadlock avoidance algorithm as std::lock).
+     *
+     * @param muts the objects to lock, must be distinct
+     * @return a tuple of guards, one for each object, in argument order
+     * @throws std::system_error in case the underlying mutex implementation throws it, no object is locked in that case
+     */
+    template<detail_lock_all::value_mutex ...Ms> requires (sizeof...(Ms) > 0)
+    [[nodiscard]] std::tuple<detail_lock_all::guard_t<Ms>...> lock_all(Ms &...muts) {
+        using detail_lock_all::lock_access;
+
+        if constexpr (sizeof...(Ms) == 1) {
+            (lock_access::raw_mutex(muts).lock(), ...);
+        } else {
+            std::lock(lock_access::raw_mutex(muts)...);
+        }
+
+        return std::tuple<detail_lock_all::guard_t<Ms>...>{lock_access::adopt(muts)...};
+    }
+
+    /**
+     * Attempt to exclusively lock all given mutex/shared_mutex objects at once without blocking.
+     * Either all objects are locked or none.
+     *
+     * @param muts the objects to lock, must be distinct
+     * @return nullopt in case any of the objects could not be locked, otherwise a tuple of guards, one for each object, in argument order
+     * @throws std::system_error in case the underlying mutex implementation throws it, no object is locked in that case
+     */
+    template<detail_lock_all::value_mutex ...Ms> requires (sizeof...(Ms) > 0)
+    [[nodiscard]] std::optional<std::tuple<detail_lock_all::guard_t<Ms>...>> try_lock_all(Ms &...muts) {
+        using detail_lock_all::lock_access;
+
+        bool locked;
+        if constexpr (sizeof...(Ms) == 1) {
+            locked = (lock_access::raw_mutex(muts).try_lock() && ...);
+        } else {
+            locked = std::try_lock(lock_access::raw_mutex(muts)...) == -1;
+        }
+
+        if (!locked) {
+            return std::nullopt;
+        }
+
+        return std::tuple<detail_lock_all::guard_t<Ms>...>{lock_access::adopt(muts)...};
+    }
+
+} // namespace dice::template_library
+
+#endif // DICE_TEMPLATELIBRARY_LOCKALL_HPP
@@ -8,6 +8,10 @@
 
 namespace dice::template_library {
 
+    namespace detail_lock_all {
+        struct lock_access;
+    } // namespace detail_lock_all
+
     template<typename T, typename Mutex = std::mutex>
     struct mutex;
 
@@ -29,6 +33,7 @@ namespace dice::template_library {
 
     private:
         friend struct mutex<T, Mutex>;
+        friend struct detail_lock_all::lock_access;
 
         value_type *value_ptr_;
         std::unique_lock<mutex_type> lock_;
@@ -76,6 +81,8 @@ namespace dice::template_library {
         using mutex_type = Mutex;
 
     private:
+        friend struct detail_lock_all::lock_access;
+
         value_type value_;
         mutex_type mutex_;
 
@@ -108,8 +115,8 @@ namespace dice::template_library {
          * @return mutex guard for the inner value
          * @throws std::system_error in case the underlying mutex implementation throws it
          */
-        [[nodiscard]] mutex_guard<value_type> lock() {
-            return mutex_guard<value_type>{std::unique_lock<mutex_type>{mutex_}, value_};
+        [[nodiscard]] mutex_guard<value_type, mutex_type> lock() {
+            return mutex_guard<value_type, mutex_type>{std::unique_lock<mutex_type>{mutex_}, value_};
         }
 
 		/**
@@ -119,13 +126,13 @@ namespace dice::template_library {
          * @return nullopt in case the mutex could not be locked, otherwise a mutex guard for the inner value
          * @throws std::system_error in case the underlying mutex implementation throws it
          */
-        [[nodiscard]] std::optional<mutex_guard<value_type>> try_lock() {
+        [[nodiscard]] std::optional<mutex_guard<value_type, mutex_type>> try_lock() {
             std::unique_lock<mutex_type> lock{mutex_, std::try_to_lock};
             if (!lock.owns_lock()) {
                 return std::nullopt;
             }
 
-            return mutex_guard<value_type>{std::move(lock), value_};
+            return mutex_guard<value_type, mutex_type>{std::move(lock), value_};
         }
     };
 
@@ -1,28 +1,141 @@
 #ifndef DICE_TEMPLATELIBRARY_POOLALLOCATOR_HPP
 #define DICE_TEMPLATELIBRARY_POOLALLOCATOR_HPP
 
-#include <boost/pool/pool.hpp>
+#include <dice/template-library/slab_pool.hpp>
 
 #include <algorithm>
 #include <array>
 #include <cstddef>
-#include <type_traits>
+#include <cstdint>
+#include <limits>
 #include <memory>
+#include <numeric>
+#include <type_traits>
 
 namespace dice::template_library {
 
+	/**
+	 * Statistics of a single bucket of a pool
+	 */
+	struct pool_bucket_stats {
+		size_t bucket_size = 0; ///< (maximum) size of allocations in this bucket
+		size_t n_allocations = 0; ///< total number of allocations served by this bucket
+		size_t n_live = 0; ///< number of allocations in this bucket that were not deallocated yet
+		size_t peak_n_live = 0; ///< maximum of n_live over time
+		size_t reserved_bytes = 0; ///< number of bytes of memory held by this bucket, including unused chunks
+	};
+
+	/**
+	 * Snapshot of the statistics of a pool, see pool::stats()
+	 *
+	 * @tparam n_buckets number of buckets of the pool
+	 */
+	template<size_t n_buckets>
+	struct pool_stats {
+		std::array<pool_bucket_stats, n_buckets> buckets{}; ///< statistics per bucket, in the order of bucket_sizes...
+		size_t n_fallback_allocations = 0; ///< total number of allocations that did not fit into any bucket and were served via new[]
+		size_t n_live_fallback_allocations = 0; ///< number of fallback allocations that were not deallocated yet
+		size_t live_fallback_bytes = 0; ///< number of bytes in live fallback allocations
+		size_t peak_live_fallback_bytes = 0; ///< maximum of live_fallback_bytes over time
+	};
+
+	namespace detail_pool_allocator {
+		/**
+		 * Whether pools count allocations, see pool::stats().
+		 * Counting can be disabled by defining DICE_TEMPLATELIBRARY_DISABLE_POOL_STATS before including this header
+		 * (consistently in all translation units).
+		 */
+#ifdef DICE_TEMPLATELIBRARY_DISABLE_POOL_STATS
+		inline constexpr bool pool_stats_enabled = false;
+#else
+		inline constexpr bool pool_stats_enabled = true;
+#endif
+
+		/**
+		 * Allocation counters of a pool.
+		 * If counting is disabled, all operations are no-ops.
+		 */
+		template<size_t n_buckets, bool enabled = pool_stats_enabled>
+		struct pool_counters {
+			void add_allocated([[maybe_unused]] size_t bucket_ix) noexcept {
+			}
+
+			void add_deallocated([[maybe_unused]] size_t bucket_ix) noexcept {
+			}
+
+			void add_fallback_allocated([[maybe_unused]] size_t n_bytes) noexcept {
+			}
+
+			void add_fallback_deallocated([[maybe_unused]] size_t n_bytes) noexcept {
+			}
+
+			void clear_live() noexcept {
+			}
+		};
+
+		template<size_t n_buckets>
+		struct pool_counters<n_buckets, true> {
+		private:
+			pool_stats<n_buckets> stats_;
+
+		public:
+			void add_allocated(size_t bucket_ix) noexcept {
+				auto &bucket = stats_.buckets[bucket_ix];
+				++bucket.n_allocations;
+				bucket.peak_n_live = std::max(bucket.peak_n_live, ++bucket.n_live);
+			}
+
+			void add_deallocated(size_t bucket_ix) noexcept {
+				--stats_.buckets[bucket_ix].n_live;
+			}
+
+			void add_fallback_allocated(size_t n_bytes) noexcept {
+				++stats_.n_fallback_allocations;
+				++stats_.n_live_fallback_allocations;
+				stats_.live_fallback_bytes += n_bytes;
+				stats_.peak_live_fallback_bytes = std::max(stats_.peak_live_fallback_bytes, stats_.live_fallback_bytes);
+			}
+
+			void add_fallback_deallocated(size_t n_bytes) noexcept {
+				--stats_.n_live_fallback_allocations;
+				stats_.live_fallback_bytes -= n_bytes;
+			}
+
+			/**
+			 * Mark all allocations in buckets as deallocated
+			 */
+			void clear_live() noexcept {
+				for (auto &bucket : stats_.buckets) {
+					bucket.n_live = 0;
+				}
+			}
+
+			/**
+			 * @return a snapshot of the counters, bucket sizes and reserved bytes are not filled in
+			 */
+			[[nodiscard]] pool_stats<n_buckets> const &snapshot() const noexcept {
+				return stats_;
+			}
+		};
+	} // namespace detail_pool_allocator
+
 	/**
 	 * A memory pool or arena that is efficient for allocations which are smaller or equal in size
 	 * for one of `bucket_sizes...`.
 	 *
 	 * The implementation consists of one arena per provided bucket size.
 	 * An allocation will be placed into the first bucket where it can fit.
+	 * The bucket is selected via a compile-time lookup table indexed by the allocation size (in multiples of the gcd of bucket_sizes...),
+	 * i.e. with a single table load independent of the number of buckets (unless that table would be huge, then a binary search is used).
 	 * Allocations that do not fit into any bucket are fulfilled with calls to `new`.
 	 *
+	 * Each arena is a slab_pool, i.e. it grows by allocating slabs that hold a number of chunks (allocations) and frees chunks in O(1).
+	 * How many slabs are allocated at once, whether they are backed by huge pages and when unused slabs are returned
+	 * to the system can be configured via pool_config.
+	 *
 	 * @tparam bucket_sizes allocation sizes for individual elements (in bytes) for the underlying arenas.
 	 *		Each size provided here is used to configure the element size of a single arena.
-	 *		Importantly, it is **not** the arena chunk size, rather it is the size of elements being placed into the arena.
-	 *		The chunk size itself as well as the maximum capacity cannot be configured, they are automatically determined by boost::pool.
+	 *		Importantly, it is **not** the arena block size, rather it is the size of elements being placed into the arena.
 	 */
 	template<size_t ...bucket_sizes>
 	struct pool {
@@ -35,52 +148,68 @@ namespace dice::template_library {
 		using difference_type = std::ptrdiff_t;
 
 	private:
-		// note: underlying allocator can not be specified via template parameter
-		// because that would be of very limited usefulness, as boost::pool requires the allocation/deallocation functions
-		// to be `static`
-		using pool_type = boost::pool<boost::default_user_allocator_new_delete>;
-
-		std::array<pool_type, sizeof...(bucket_sizes)> pools_;
-
-		template<size_t ix, size_t bucket_size, size_t ...rest>
-		void *allocate_impl(size_t n_bytes) {
-			if (n_bytes <= bucket_size) {
-				// fits into bucket
-
-				void *ptr = pools_[ix].malloc();
-				if (ptr == nullptr) [[unlikely]] {
-					// boost::pool uses null-return instead of exception
-					throw std::bad_alloc{};
-				}
-				return ptr;
+		static constexpr size_t n_buckets = sizeof...(bucket_sizes);
+		static constexpr std::array<size_t, n_buckets> bucket_sizes_arr{bucket_sizes...};
+		static constexpr size_t max_bucket_size = bucket_sizes_arr.back();
+
+		/**
+		 * Largest number that divides all (non-zero) bucket sizes.
+		 * All sizes in ((i - 1) * granularity, i * granularity] fit into the same (smallest) bucket.
+		 */
+		static constexpr size_t granularity = [] {
+			size_t res = 0;
+			for (auto const bucket_size : bucket_sizes_arr) {
+				res = std::gcd(res, bucket_size);
 			}
+			return res == 0 ? 1 : res;
+		}();
 
-			if constexpr (sizeof...(rest) > 0) {
-				return allocate_impl<ix + 1, rest...>(n_bytes);
-			} else {
-				// does not fit into any bucket, fall back to new[]
-				return new char[n_bytes];
+		// upper bound for the size of lookup_table, for very fine-grained and large buckets a binary search is used instead
+		static constexpr size_t max_lookup_table_size = size_t{1} << 16;
+		static constexpr size_t lookup_table_size = max_bucket_size / granularity + 1;
+		static constexpr bool use_lookup_table = lookup_table_size <= max_lookup_table_size;
+
+		using bucket_index_type = std::conditional_t<(n_buckets < std::numeric_limits<uint8_t>::max()), uint8_t, size_t>;
+
+		/**
+		 * lookup_table[ceil(n_bytes / granularity)] is the index of the smallest bucket that n_bytes fit into
+		 */
+		static constexpr auto lookup_table = [] {
+			std::array<bucket_index_type, use_lookup_table ? lookup_table_size : 0> res{};
+			size_t bucket_ix = 0;
+			for (size_t ix = 0; ix < res.size(); ++ix) {
+				while (bucket_sizes_arr[bucket_ix] < ix * granularity) {
+					++bucket_ix;
+				}
+				res[ix] = static_cast<bucket_index_type>(bucket_ix);
 			}
-		}
+			return res;
+		}();
 
-		template<size_t ix, size_t bucket_size, size_t ...rest>
-		void deallocate_impl(void *data, size_t n_bytes) {
-			if (n_bytes <= bucket_size) {
-				// fits into bucket
-				pools_[ix].free(data);
-				return;
+		/**
+		 * @return index of the smallest bucket that n_bytes fit into, or n_buckets if they do not fit into any bucket
+		 */
+		[[nodiscard]] static constexpr size_t bucket_index(size_t n_bytes) noexcept {
+			if (n_bytes > max_bucket_size) [[unlikely]] {
+				return n_buckets;
 			}
 
-			if constexpr (sizeof...(rest) > 0) {
-				deallocate_impl<ix + 1, rest...>(data, n_bytes);
+			if constexpr (use_lookup_table) {
+				return lookup_table[(n_bytes + granularity - 1) / granularity];
 			} else {
-				// does not fit into any bucket, must have been allocated via new[]
-				delete[] static_cast<char *>(data);
+				return std::ranges::lower_bound(bucket_sizes_arr, n_bytes) - bucket_sizes_arr.begin();
 			}
 		}
 
+		std::array<slab_pool, n_buckets> pools_;
+		[[no_unique_address]] detail_pool_allocator::pool_counters<n_buckets> counters_;
+
 	public:
-		pool() : pools_{pool_type{bucket_sizes}...} {
+		pool() : pool{pool_config{}} {
+		}
+
+		explicit pool(pool_config const &config)
+			: pools_{slab_pool{bucket_sizes, config}...} {
 		}
 
 		// underlying implementation does not support copying/moving
@@ -101,7 +230,17 @@ namespace dice::template_library {
 		 * @throws std::bad_alloc on allocation failure
 		 */
 		void *allocate(size_t n_bytes) {
-			return allocate_impl<0, bucket_sizes...>(n_bytes);
+			auto const bucket_ix = bucket_index(n_bytes);
+			if (bucket_ix == n_buckets) [[unlikely]] {
+				// does not fit into any bucket, fall back to new[]
+				auto *ptr = new char[n_bytes];
+				counters_.add_fallback_allocated(n_bytes);
+				return ptr;
+			}
+
+			void *ptr = pools_[bucket_ix].allocate();
+			counters_.add_allocated(bucket_ix);
+			return ptr;
 		}
 
 		/**
@@ -111,7 +250,59 @@ namespace dice::template_library {
 		 * @param n_bytes size in bytes of the previously allocated region. Note: `n_bytes` must be the same value as was provided for the call to `allocate` that allocated `data`.
 		 */
 		void deallocate(void *data, size_t n_bytes) {
-			return deallocate_impl<0, bucket_sizes...>(data, n_bytes);
+			auto const bucket_ix = bucket_index(n_bytes);
+			if (bucket_ix == n_buckets) [[unlikely]] {
+				// does not fit into any bucket, must have been allocated via new[]
+				delete[] static_cast<char *>(data);
+				counters_.add_fallback_deallocated(n_bytes);
+				return;
+			}
+
+			pools_[bucket_ix].deallocate(data);
+			counters_.add_deallocated(bucket_ix);
+		}
+
+		/**
+		 * Return memory (slabs) that does not contain any live allocations back to the system, e.g. after a peak in memory usage.
+		 * Takes O(n) time in the number of slabs with unused chunks.
+		 *
+		 * @return true if any memory was freed
+		 */
+		bool release_unused() noexcept {
+			bool released = false;
+			for (auto &p : pools_) {
+				released |= p.release_unused();
+			}
+			return released;
+		}
+
+		/**
+		 * Return all memory of all buckets back to the system.
+		 * This is much cheaper than release_unused() but invalidates all allocations that were served by a bucket
+		 * (allocations that did not fit into any bucket are unaffected).
+		 *
+		 * @pre there are no live allocations in any bucket, or they are never used or deallocated again
+		 */
+		void purge_memory() noexcept {
+			for (auto &p : pools_) {
+				p.purge_memory();
+			}
+			counters_.clear_live();
+		}
+
+		/**
+		 * Get a snapshot of the statistics of this pool, e.g. to check how well bucket_sizes... fit the actual allocations.
+		 * Only available if DICE_TEMPLATELIBRARY_DISABLE_POOL_STATS is not defined.
+		 *
+		 * @return statistics per bucket and of allocations that did not fit into any bucket
+		 */
+		[[nodiscard]] pool_stats<n_buckets> stats() const noexcept requires (detail_pool_allocator::pool_stats_enabled) {
+			auto ret = counters_.snapshot();
+			for (size_t ix = 0; ix < n_buckets; ++ix) {
+				ret.buckets[ix].bucket_size = bucket_sizes_arr[ix];
+				ret.buckets[ix].reserved_bytes = pools_[ix].reserved_bytes();
+			}
+			return ret;
 		}
 	};
 
@@ -156,6 +347,13 @@ namespace dice::template_library {
 			: pool_{std::make_shared<pool<bucket_sizes...>>()} {
 		}
 
+		/**
+		 * Creates a pool_allocator with a pool with the given config
+		 */
+		explicit pool_allocator(pool_config const &config)
+			: pool_{std::make_shared<pool<bucket_sizes...>>(config)} {
+		}
+
 		explicit pool_allocator(std::shared_ptr<pool<bucket_sizes...>> underlying_pool)
 			: pool_{std::move(underlying_pool)} {
 		}
@@ -0,0 +1,448 @@
+#ifndef DICE_TEMPLATELIBRARY_PRIORITYCHANNEL_HPP
+#define DICE_TEMPLATELIBRARY_PRIORITYCHANNEL_HPP
+
+#include <dice/template-library/channel.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace dice::template_library {
+
+    namespace detail_priority_channel {
+        /**
+         * An implicit d-ary max-heap (with respect to Compare) stored in a std::vector.
+         * Compared to a binary heap, all children of a node are adjacent in memory and the heap is less deep,
+         * which results in fewer cache misses when sifting elements down.
+         *
+         * @tparam T element type
+         * @tparam Compare strict weak ordering, the greatest element is at the top (same as for std::priority_queue)
+         * @tparam arity number of children per node
+         */
+        template<typename T, typename Compare, size_t arity = 4>
+        struct dary_heap {
+            static_assert(arity >= 2);
+
+        private:
+            std::vector<T> elems_;
+            [[no_unique_address]] Compare compare_;
+
+            static constexpr size_t parent_of(size_t ix) noexcept {
+                return (ix - 1) / arity;
+            }
+
+            static constexpr size_t first_child_of(size_t ix) noexcept {
+                return arity * ix + 1;
+            }
+
+            /**
+             * Move the element at the end of elems_ up to its position
+             */
+            void sift_up() noexcept(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>) {
+                auto ix = elems_.size() - 1;
+                if (ix == 0) {
+                    return;
+                }
+
+                T elem = std::move(elems_[ix]);
+                while (ix > 0) {
+                    auto const parent = parent_of(ix);
+                    if (!compare_(elems_[parent], elem)) {
+                        break;
+                    }
+
+                    elems_[ix] = std::move(elems_[parent]);
+                    ix = parent;
+                }
+                elems_[ix] = std::move(elem);
+            }
+
+            /**
+             * Put elem into the hole at the root and move it down to its position
+             */
+            void sift_down(T elem) noexcept(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>) {
+                auto const n = elems_.size();
+                size_t ix = 0;
+
+                while (true) {
+                    auto const first_child = first_child_of(ix);
+                    if (first_child >= n) {
+                        break;
+                    }
+
+                    auto const last_child = std::min(first_child + arity, n);
+                    auto max_child = first_child;
+                    for (auto child = first_child + 1; child < last_child; ++child) {
+                        if (compare_(elems_[max_child], elems_[child])) {
+                            max_child = child;
+                        }
+                    }
+
+                    if (!compare_(elem, elems_[max_child])) {
+                        break;
+                    }
+
+                    elems_[ix] = std::move(elems_[max_child]);
+                    ix = max_child;
+                }
+                elems_[ix] = std::move(elem);
+            }
+
+        public:
+            explicit dary_heap(Compare compare = Compare{}) noexcept(std::is_nothrow_move_constructible_v<Compare>)
+                : compare_{std::move(compare)} {
+            }
+
+            void reserve(size_t capacity) {
+                elems_.reserve(capacity);
+            }
+
+            [[nodiscard]] size_t size() const noexcept {
+                return elems_.size();
+            }
+
+            [[nodiscard]] bool empty() const noexcept {
+                return elems_.empty();
+            }
+
+            /**
+             * @pre !empty()
+             * @return the greatest element
+             */
+            [[nodiscard]] T const &top() const noexcept {
+                assert(!empty());
+                return elems_.front();
+            }
+
+            template<typename ...Args>
+            void emplace(Args &&...args) {
+                elems_.emplace_back(std::forward<Args>(args)...);
+                sift_up();
+            }
+
+            /**
+             * Remove and return the greatest element
+             * @pre !empty()
+             */
+            T pop() noexcept(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>) {
+                assert(!empty());
+
+                T ret = std::move(elems_.front());
+                T last = std::move(elems_.back());
+                elems_.pop_back();
+
+                if (!elems_.empty()) {
+                    sift_down(std::move(last));
+                }
+                return ret;
+            }
+        };
+    } // namespace detail_priority_channel
+
+    /**
+     * A multi producer, multi consumer channel/queue that always pops the element with the highest priority.
+     * The elements are kept in a d-ary heap that is allocated once with the full capacity.
+     *
+     * Apart from the order in which elements are popped, it behaves like channel:
+     * it is bounded by capacity, pushing blocks if the channel is full, popping blocks if it is empty,
+     * and after close() the remaining elements can still be popped.
+     *
+     * @warning close() must be called once the producing threads are done, otherwise the reading thread will hang indefinitely
+     *
+     * @tparam T value type of the channel
+     * @tparam Compare strict weak ordering of the elements, the greatest element is popped first (same as for std::priority_queue)
+     */
+    template<typename T, typename Compare = std::less<T>>
+    struct priority_channel {
+        using value_type = T;
+        using value_compare = Compare;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = value_type &;
+        using const_reference = value_type const &;
+        using pointer = T *;
+        using const_pointer = T const *;
+
+    private:
+        size_t max_cap_; ///< maximum allowed number of elements in heap_
+        detail_priority_channel::dary_heap<T, Compare> heap_; ///< heap of elements
+
+        std::atomic_flag closed_ = ATOMIC_FLAG_INIT; ///< true if this channel is closed
+        std::mutex heap_mutex_; ///< mutex for heap_
+        std::condition_variable heap_not_empty_; ///< condvar for heap_.size() > 0
+        std::condition_variable heap_not_full_;  ///< condvar for heap_.size() < max_cap_;
+
+        /**
+         * Wake up as many waiting threads as are required to handle n changes to heap_
+         */
+        static void notify_n(std::condition_variable &condvar, size_t n) noexcept {
+            if (n == 1) {
+                condvar.notify_one();
+            } else if (n > 1) {
+                condvar.notify_all();
+            }
+        }
+
+    public:
+        /**
+         * @param capacity maximum number of elements the channel can hold.
+         * @param compare comparator for the elements
+         * @note memory for all `capacity` elements is allocated up front, the channel does not allocate after construction
+         */
+        explicit priority_channel(size_t capacity, Compare compare = Compare{}) : max_cap_{capacity},
+                                                                                  heap_{std::move(compare)} {
+            heap_.reserve(max_cap_);
+        }
+
+        // there is no way to safely implement these with concurrent access
+        priority_channel(priority_channel const &other) = delete;
+        priority_channel(priority_channel &&other) = delete;
+        priority_channel &operator=(priority_channel const &other) = delete;
+        priority_channel &operator=(priority_channel &&other) noexcept = delete;
+
+        ~priority_channel() noexcept = default;
+
+        /**
+         * Close the channel.
+         * After calling close calls to push() will return false
+         * and calls to try_pop will return std::nullopt once the already present elements are exhausted
+         */
+        void close() noexcept {
+            {
+                // see channel::close()
+                std::lock_guard lock{heap_mutex_};
+                closed_.test_and_set(std::memory_order_release);
+            }
+            heap_not_empty_.notify_all(); // notify pop() so that it does not get stuck
+            heap_not_full_.notify_all(); // notify emplace()
+        }
+
+        /**
+         * @return true if this channel is closed
+         */
+        [[nodiscard]] bool closed() const noexcept {
+            return closed_.test(std::memory_order_acquire);
+        }
+
+        /**
+         * Emplace an element into the channel, blocks if there is no capacity left in the channel.
+         *
+         * @param args constructor args
+         * @return true if emplacing the element succeeded because the channel is not yet closed
+         */
+        template<typename ...Args>
+        bool emplace(Args &&...args) noexcept(std::is_nothrow_constructible_v<value_type, decltype(std::forward<Args>(args))...>) {
+            if (closed_.test(std::memory_order_acquire)) [[unlikely]] {
+                return false;
+            }
+
+            {
+                std::unique_lock lock{heap_mutex_};
+                heap_not_full_.wait(lock, [this]() noexcept { return heap_.size() < max_cap_ || closed_.test(std::memory_order_relaxed); });
+
+                if (closed_.test(std::memory_order_relaxed)) [[unlikely]] {
+                    // relaxed is enough because we hold the lock
+                    return false;
+                }
+
+                heap_.emplace(std::forward<Args>(args)...);
+            }
+
+            heap_not_empty_.notify_one();
+            return true;
+        }
+
+        /**
+         * Emplace an element into the channel, returns immediately if there is no capacity in the channel.
+         *
+         * @param args constructor args
+         * @return true if emplacing the element succeeded
+         */
+        template<typename ...Args>
+        bool try_emplace(Args &&...args) noexcept(std::is_nothrow_constructible_v<value_type, decltype(std::forward<Args>(args))...>) {
+            if (closed_.test(std::memory_order_acquire)) [[unlikely]] {
+                return false;
+            }
+
+            {
+                std::unique_lock lock{heap_mutex_};
+                if (heap_.size() >= max_cap_ || closed_.test(std::memory_order_relaxed)) {
+                    // relaxed is enough because we hold the lock
+                    return false;
+                }
+
+                heap_.emplace(std::forward<Args>(args)...);
+            }
+
+            heap_not_empty_.notify_one();
+            return true;
+        }
+
+        /**
+         * Push a single element into the channel, blocks if there is no capacity left in the channel.
+         *
+         * @param value the element to push
+         * @return true if pushing the element succeeded because the channel is not yet closed
+         */
+        bool push(value_type const &value) noexcept(std::is_nothrow_copy_constructible_v<value_type>) {
+            return emplace(value);
+        }
+
+        /**
+         * Push a single element into the channel, returns immediately if there is no capacity in the channel.
+         *
+         * @param value the element to push
+         * @return true if pushing the element succeeded because the channel is not yet closed
+         */
+        bool try_push(value_type const &value) noexcept(std::is_nothrow_copy_constructible_v<value_type>) {
+            return try_emplace(value);
+        }
+
+        /**
+         * Push a single element into the channel, blocks if there is no capacity left in the channel.
+         *
+         * @param value the element to push
+         * @return true if pushing the element succeeded because the channel is not yet closed
+         */
+        bool push(value_type &&value) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            return emplace(std::move(value));
+        }
+
+        /**
+         * Push a single element into the channel, returns immediately if there is no capacity in the channel.
+         *
+         * @param value the element to push
+         * @return true if pushing the element succeeded because the channel is not yet closed
+         */
+        bool try_push(value_type &&value) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            return try_emplace(std::move(value));
+        }
+
+        /**
+         * Get the (previously pushed) element with the highest priority from the channel.
+         * If there is no element available, blocks until there is one available or the channel is closed.
+         *
+         * @return std::nullopt if the channel was closed, an element otherwise
+         */
+        [[nodiscard]] std::optional<value_type> pop() noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            std::unique_lock lock{heap_mutex_};
+            heap_not_empty_.wait(lock, [this]() noexcept { return !heap_.empty() || closed_.test(std::memory_order_relaxed); });
+
+            if (heap_.empty()) [[unlikely]] {
+                // implies closed_ == true
+                return std::nullopt;
+            }
+
+            auto ret = heap_.pop();
+
+            lock.unlock();
+            heap_not_full_.notify_one();
+            return ret;
+        }
+
+        /**
+         * Get the (previously pushed) element with the highest priority from the channel.
+         * Unlike pop(), if there is no element available, returns std::nullopt immediatly.
+         */
+        [[nodiscard]] std::optional<value_type> try_pop() noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            std::unique_lock lock{heap_mutex_};
+            if (heap_.empty()) {
+                return std::nullopt;
+            }
+
+            auto ret = heap_.pop();
+
+            lock.unlock();
+            heap_not_full_.notify_one();
+            return ret;
+        }
+
+        /**
+         * Get up to max_batch_size (previously pushed) elements with the highest priorities from the channel, in order of priority.
+         * If there is no element available, blocks until there is at least one available or the channel is closed.
+         * All elements are removed under a single lock acquisition followed by a single notification.
+         *
+         * @param out output iterator the elements are moved to
+         * @param max_batch_size maximum number of elements to get, must be greater than 0
+         * @return the number of elements written to out, 0 if the channel was closed
+         */
+        template<std::output_iterator<value_type &&> OutputIt>
+        size_t pop_batch(OutputIt out, size_t max_batch_size) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            assert(max_batch_size > 0);
+
+            std::unique_lock lock{heap_mutex_};
+            heap_not_empty_.wait(lock, [this]() noexcept { return !heap_.empty() || closed_.test(std::memory_order_relaxed); });
+
+            size_t n = 0;
+            for (; n < max_batch_size && !heap_.empty(); ++n) {
+                *out = heap_.pop();
+                ++out;
+            }
+
+            lock.unlock();
+            notify_n(heap_not_full_, n);
+            return n;
+        }
+
+        /**
+         * Get up to max_batch_size (previously pushed) elements with the highest priorities from the channel, in order of priority.
+         * Unlike pop_batch(), if there is no element available, returns 0 immediately.
+         *
+         * @param out output iterator the elements are moved to
+         * @param max_batch_size maximum number of elements to get
+         * @return the number of elements written to out
+         */
+        template<std::output_iterator<value_type &&> OutputIt>
+        size_t try_pop_batch(OutputIt out, size_t max_batch_size) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            std::unique_lock lock{heap_mutex_};
+
+            size_t n = 0;
+            for (; n < max_batch_size && !heap_.empty(); ++n) {
+                *out = heap_.pop();
+                ++out;
+            }
+
+            lock.unlock();
+            notify_n(heap_not_full_, n);
+            return n;
+        }
+
+        using iterator = detail_channel::channel_iterator<priority_channel>;
+        using batched_view = detail_channel::batched_channel_view<priority_channel>;
+        using sentinel = std::default_sentinel_t;
+
+        /**
+         * @return an iterator over all present and future elements of this channel, in order of priority at the time they are popped
+         * @note iterator == end() is true once the channel is closed
+         */
+        [[nodiscard]] iterator begin() noexcept {
+            return iterator{this};
+        }
+
+        [[nodiscard]] sentinel end() const noexcept {
+            return std::default_sentinel;
+        }
+
+        /**
+         * @param max_batch_size maximum number of elements that are removed from the channel at once, must be greater than 0
+         * @return a range over all present and future elements of this channel, that removes elements from the channel in batches (see pop_batch)
+         * @note like begin()/end(), the range ends once the channel is closed
+         * @warning elements that were removed from the channel but not yet reached by the iteration are lost if the iteration is stopped early
+         */
+        [[nodiscard]] batched_view batched(size_t max_batch_size) noexcept {
+            return batched_view{this, max_batch_size};
+        }
+    };
+
+} // namespace dice::template_library
+
+#endif // DICE_TEMPLATELIBRARY_PRIORITYCHANNEL_HPP
@@ -0,0 +1,222 @@
+#ifndef DICE_TEMPLATELIBRARY_RCU_HPP
+#define DICE_TEMPLATELIBRARY_RCU_HPP
+
+#include <dice/template-library/striped_shared_mutex.hpp>
+
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace dice::template_library {
+
+    template<typename T, size_t n_stripes = 64>
+    struct rcu;
+
+    /**
+     * An RAII guard for reading the version of the value of an rcu that was current when the guard was created.
+     * While this guard is alive, that version is not reclaimed, even if writers publish newer versions in the meantime.
+     *
+     * @note to use this correctly it is important to understand that unlike rust, C++ cannot
+     *       enforce that you do not use pointers given out by this type beyond its lifetime.
+     *       You may not store pointers or references given out via this wrapper beyond its lifetime, otherwise behaviour is undefined.
+     *
+     * @tparam T the value type protected by the rcu
+     */
+    template<typename T>
+    struct rcu_guard {
+        using value_type = T const;
+
+    private:
+        template<typename, size_t>
+        friend struct rcu;
+
+        value_type *value_ptr_;
+        std::atomic<uint32_t> *reader_counter_; ///< the counter this reader is registered in, nullptr if moved-from
+
+        rcu_guard(std::atomic<uint32_t> &reader_counter, value_type &value) noexcept
+            : value_ptr_{&value},
+              reader_counter_{&reader_counter} {
+        }
+
+        void release() noexcept {
+            if (reader_counter_ != nullptr) {
+                reader_counter_->fetch_sub(1, std::memory_order_release);
+            }
+        }
+
+    public:
+        rcu_guard() = delete;
+        rcu_guard(rcu_guard const &other) noexcept = delete;
+        rcu_guard &operator=(rcu_guard const &other) noexcept = delete;
+
+        rcu_guard(rcu_guard &&other) noexcept
+            : value_ptr_{other.value_ptr_},
+              reader_counter_{std::exchange(other.reader_counter_, nullptr)} {
+        }
+
+        rcu_guard &operator=(rcu_guard &&other) noexcept {
+            if (this != &other) {
+                release();
+                value_ptr_ = other.value_ptr_;
+                reader_counter_ = std::exchange(other.reader_counter_, nullptr);
+            }
+            return *this;
+        }
+
+        ~rcu_guard() {
+            release();
+        }
+
+        value_type *operator->() const noexcept {
+            return value_ptr_;
+        }
+
+        value_type &operator*() const noexcept {
+            return *value_ptr_;
+        }
+    };
+
+    /**
+     * A read-copy-update (RCU) container for rarely updated, frequently read values.
+     *
+     * Readers get a wait-free guard to the current version of the value (see read()), they never block and are never blocked by writers.
+     * Writers never modify the current version in place, instead they publish a new version (see store() and update())
+     * and then wait for a grace period, i.e. until all readers that might still hold the previous version have released it, before reclaiming it.
+     *
+     * Readers register in per-thread striped counters (one pair per stripe) that are selected by the current epoch (grace period) parity.
+     * To wait for a grace period, a writer flips the epoch twice, each time waiting until the counters of the previous parity drained,
+     * so that readers that keep coming in do not starve the writer.
+     *
+     * @note Updating is expensive (a copy of the value and a grace period wait), this is only suitable for values that are read much more frequently than they are written.
+     * @note This type is non-movable and non-copyable, if you need to do either of these things use `std::unique_ptr<rcu<T>>` or `std::shared_ptr<rcu<T>>`
+     * @warning A thread must not call store() or update() while it holds an rcu_guard of the same rcu, this would deadlock.
+     *
+     * @tparam T value type stored
+     * @tparam n_stripes number of reader counter stripes
+     */
+    template<typename T, size_t n_stripes>
+    struct rcu {
+        static_assert(n_stripes > 0);
+
+        using value_type = T;
+        using guard_type = rcu_guard<T>;
+
+    private:
+        struct alignas(detail_striped_shared_mutex::cache_line_size) stripe {
+            std::array<std::atomic<uint32_t>, 2> n_readers{}; ///< readers per epoch parity
+        };
+
+        std::atomic<value_type *> current_; ///< the current version
+        mutable std::array<stripe, n_stripes> stripes_; ///< reader counters, readers register here, so this needs to be mutable
+        alignas(detail_striped_shared_mutex::cache_line_size) std::atomic<uint64_t> epoch_ = 0; ///< incremented twice per grace period
+        std::mutex writer_mutex_; ///< serializes writers
+
+        /**
+         * Wait until all readers that started before this call have released their guards
+         * @pre writer_mutex_ is held
+         */
+        void synchronize() noexcept {
+            for (int flip = 0; flip < 2; ++flip) {
+                // new readers register in the other parity, the previous parity is drained eventually
+                auto const prev_parity = epoch_.fetch_add(1, std::memory_order_seq_cst) & 1;
+
+                for (auto &s : stripes_) {
+                    while (s.n_readers[prev_parity].load(std::memory_order_seq_cst) != 0) {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+        }
+
+        /**
+         * Publish a new version and reclaim the previous one once all readers have released it
+         * @pre writer_mutex_ is held
+         */
+        void publish(std::unique_ptr<value_type> next) noexcept {
+            std::unique_ptr<value_type> prev{current_.exchange(next.release(), std::memory_order_seq_cst)};
+            synchronize();
+        }
+
+    public:
+        rcu() requires (std::default_initializable<value_type>)
+            : current_{new value_type()} {
+        }
+
+        explicit rcu(value_type const &value)
+            : current_{new value_type(value)} {
+        }
+
+        explicit rcu(value_type &&value)
+            : current_{new value_type(std::move(value))} {
+        }
+
+        template<typename ...Args>
+        explicit rcu(std::in_place_t, Args &&...args)
+            : current_{new value_type(std::forward<Args>(args)...)} {
+        }
+
+        rcu(rcu const &other) = delete;
+        rcu(rcu &&other) = delete;
+        rcu &operator=(rcu const &other) = delete;
+        rcu &operator=(rcu &&other) = delete;
+
+        /**
+         * @pre there are no guards of this rcu alive
+         */
+        ~rcu() {
+            delete current_.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * Get a guard that allows read-only access to the current version of the value. This is wait-free.
+         * @return guard to the current version
+         */
+        [[nodiscard]] guard_type read() const noexcept {
+            auto &s = stripes_[detail_striped_shared_mutex::thread_stripe_hint() % n_stripes];
+
+            // seq_cst pairs with synchronize(): either the writer sees this reader or this reader sees the new version
+            auto &counter = s.n_readers[epoch_.load(std::memory_order_seq_cst) & 1];
+            counter.fetch_add(1, std::memory_order_seq_cst);
+            return guard_type{counter, *current_.load(std::memory_order_seq_cst)};
+        }
+
+        /**
+         * Publish a new version of the value. Blocks until the previous version is no longer used by any reader.
+         * @param value the new value
+         */
+        void store(value_type value) {
+            auto next = std::make_unique<value_type>(std::move(value));
+
+            std::lock_guard lock{writer_mutex_};
+            publish(std::move(next));
+        }
+
+        /**
+         * Copy the current version of the value, modify the copy via func and publish it as the new version.
+         * Concurrent updates are serialized, so no update is lost.
+         * Blocks until the previous version is no longer used by any reader.
+         *
+         * @param func callable that modifies the copy in place
+         */
+        template<typename F> requires (std::invocable<F, value_type &>)
+        void update(F &&func) {
+            std::lock_guard lock{writer_mutex_};
+
+            // only writers replace current_ and they are serialized, so it is safe to read it without registering as a reader
+            auto next = std::make_unique<value_type>(*current_.load(std::memory_order_relaxed));
+            std::invoke(std::forward<F>(func), *next);
+            publish(std::move(next));
+        }
+    };
+
+} // namespace dice::template_library
+
+#endif // DICE_TEMPLATELIBRARY_RCU_HPP
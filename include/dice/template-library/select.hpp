@@ -0,0 +1,102 @@
+#ifndef DICE_TEMPLATELIBRARY_SELECT_HPP
+#define DICE_TEMPLATELIBRARY_SELECT_HPP
+
+#include <dice/template-library/channel.hpp>
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace dice::template_library {
+
+    /**
+     * A channel that can be waited on via select(), i.e. channel and exchange_channel
+     */
+    template<typename Channel>
+    concept selectable_channel = requires (Channel &chan) {
+        typename Channel::value_type;
+        { chan.try_pop() } -> std::same_as<std::optional<typename Channel::value_type>>;
+        { chan.drained() } -> std::same_as<bool>;
+        { detail_channel::select_access::waiters(chan) } -> std::same_as<detail_channel::select_waiter_list &>;
+    };
+
+    namespace detail_select {
+        /**
+         * Try to pop an element from each of the channels, in order, until one succeeds.
+         *
+         * @param all_drained set to true if no element was found and all channels are closed and drained
+         * @return the first element that could be popped, the index of the alternative is the index of the channel it was popped from
+         */
+        template<typename Result, size_t ...ixs, typename ...Channels>
+        std::optional<Result> try_pop_any(bool &all_drained, std::index_sequence<ixs...>, Channels &...chans) noexcept(std::is_nothrow_move_constructible_v<Result>) {
+            std::optional<Result> ret;
+            all_drained = true;
+
+            auto try_pop_one = [&]<size_t ix>(std::integral_constant<size_t, ix>, auto &chan) {
+                if (auto elem = chan.try_pop(); elem.has_value()) {
+                    ret.emplace(std::in_place_index<ix>, std::move(*elem));
+                    return true;
+                }
+
+                if (!chan.drained()) {
+                    all_drained = false;
+                }
+                return false;
+            };
+
+            (try_pop_one(std::integral_constant<size_t, ixs>{}, chans) || ...);
+            return ret;
+        }
+    } // namespace detail_select
+
+    /**
+     * Wait until any of the given channels has an element available and pop it.
+     * Channels that are closed and drained are skipped.
+     *
+     * All channels share a single waiter, so the calling thread sleeps until any of them receives an element or is closed
+     * instead of polling them.
+     * If multiple channels have an element available, the one that comes first in the argument list is chosen.
+     *
+     * @param chans the channels to wait on
+     * @return std::nullopt if all channels are closed and drained,
+     *         otherwise the popped element, the index of the active alternative is the index of the channel it was popped from
+     */
+    template<selectable_channel ...Channels> requires (sizeof...(Channels) > 0)
+    [[nodiscard]] std::optional<std::variant<typename Channels::value_type...>> select(Channels &...chans) noexcept((std::is_nothrow_move_constructible_v<typename Channels::value_type> && ...)) {
+        using result_type = std::variant<typename Channels::value_type...>;
+        auto const ixs = std::index_sequence_for<Channels...>{};
+
+        bool all_drained;
+        if (auto ret = detail_select::try_pop_any<result_type>(all_drained, ixs, chans...); ret.has_value() || all_drained) {
+            return ret;
+        }
+
+        detail_channel::select_waiter waiter;
+        std::array<detail_channel::select_waiter_node, sizeof...(Channels)> nodes;
+
+        auto register_all = [&]<size_t ...ix>(std::index_sequence<ix...>) noexcept {
+            ((nodes[ix].waiter = &waiter, detail_channel::select_access::waiters(chans).add(nodes[ix])), ...);
+        };
+        auto unregister_all = [&]<size_t ...ix>(std::index_sequence<ix...>) noexcept {
+            (detail_channel::select_access::waiters(chans).remove(nodes[ix]), ...);
+        };
+
+        register_all(ixs);
+        while (true) {
+            // re-check after registering, so that an element pushed in the meantime is not missed
+            if (auto ret = detail_select::try_pop_any<result_type>(all_drained, ixs, chans...); ret.has_value() || all_drained) {
+                unregister_all(ixs);
+                return ret;
+            }
+
+            waiter.wait();
+        }
+    }
+
+} // namespace dice::template_library
+
+#endif // DICE_TEMPLATELIBRARY_SELECT_HPP
@@ -0,0 +1,321 @@
+#ifndef DICE_TEMPLATELIBRARY_SEQLOCKEXCHANGECHANNEL_HPP
+#define DICE_TEMPLATELIBRARY_SEQLOCKEXCHANGECHANNEL_HPP
+
+#include <dice/template-library/channel.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <iterator>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <type_traits>
+
+namespace dice::template_library {
+
+    /**
+     * A multi producer, multi consumer channel that only retains the last sent value (like exchange_channel)
+     * for small, trivially copyable values, that does not lock on either side.
+     *
+     * The value is protected by a seqlock: writers mark the state as "writing", copy the value in and publish a new sequence number,
+     * readers copy the value out and retry if the sequence number changed in the meantime (i.e. the copy may be torn).
+     * A consuming read (try_pop(), pop()) additionally marks the current sequence number as consumed in the same atomic step
+     * that validates the copy, so each value is still consumed by at most one consumer. try_peek() reads the latest value without consuming it.
+     * Threads only block in pop() if there is no value available.
+     *
+     * Unlike exchange_channel, this does not support coroutines (co_pop/co_push) or instrumentation.
+     * Values are copied in and out in full, so this is only beneficial for values that are a few cache lines large at most.
+     *
+     * @tparam T value type of the channel, must be trivially copyable
+     * @tparam WaitPolicy how threads wait in pop() before they block, see park_wait_policy, spin_wait_policy and adaptive_wait_policy
+     */
+    template<typename T, typename WaitPolicy = adaptive_wait_policy<>>
+    struct seqlock_exchange_channel {
+        static_assert(std::is_trivially_copyable_v<T>, "seqlock_exchange_channel requires a trivially copyable value type");
+
+        using value_type = T;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = value_type &;
+        using const_reference = value_type const &;
+        using pointer = T *;
+        using const_pointer = T const *;
+
+    private:
+        static constexpr size_t n_words = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+        // layout of state_: | sequence number (62 bit) | consumed bit | writing bit |
+        static constexpr uint64_t writing_bit = 0b01;
+        static constexpr uint64_t consumed_bit = 0b10;
+        static constexpr uint64_t sequence_one = 0b100;
+
+        alignas(detail_channel::cache_line_size) std::atomic<uint64_t> state_ = consumed_bit; ///< seqlock state, initially there is no value, which is equivalent to it being consumed
+        std::array<std::atomic<uint64_t>, n_words> words_{}; ///< the value, stored as atomic words so that concurrent (torn) reads are not data races
+
+        // everything below is only touched if a thread needs to block or the channel is closed
+        alignas(detail_channel::cache_line_size) std::atomic_flag closed_ = ATOMIC_FLAG_INIT; ///< true if this channel is closed
+        std::mutex park_mutex_; ///< mutex for has_value_
+        detail_channel::channel_parking_spot<channel_instrumentation::disabled, WaitPolicy> has_value_; ///< consumers wait for "there is an unconsumed value or the channel is closed"
+        detail_channel::select_waiter_list select_waiters_; ///< threads in select() waiting for this channel
+
+        friend struct detail_channel::select_access;
+
+        [[nodiscard]] static bool has_unconsumed_value(uint64_t state) noexcept {
+            return (state & consumed_bit) == 0;
+        }
+
+        /**
+         * Wait until no writer is active
+         * @return the state without the writing bit set
+         */
+        [[nodiscard]] uint64_t load_stable_state() const noexcept {
+            auto state = state_.load(std::memory_order_acquire);
+            while (state & writing_bit) [[unlikely]] {
+                detail_channel::cpu_relax();
+                state = state_.load(std::memory_order_acquire);
+            }
+            return state;
+        }
+
+        /**
+         * Copy the value out of words_. The result may be torn if a writer is active concurrently, which needs to be checked by the caller.
+         */
+        [[nodiscard]] value_type load_value() const noexcept {
+            std::array<uint64_t, n_words> buf;
+            for (size_t ix = 0; ix < n_words; ++ix) {
+                buf[ix] = words_[ix].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            // memcpy implicitly creates the trivially copyable T in storage
+            alignas(T) std::byte storage[sizeof(T)];
+            std::memcpy(storage, buf.data(), sizeof(T));
+            return *std::launder(reinterpret_cast<T *>(storage));
+        }
+
+        void store_value(value_type const &value) noexcept {
+            std::array<uint64_t, n_words> buf{};
+            std::memcpy(buf.data(), &value, sizeof(T));
+            for (size_t ix = 0; ix < n_words; ++ix) {
+                words_[ix].store(buf[ix], std::memory_order_relaxed);
+            }
+        }
+
+    public:
+        seqlock_exchange_channel() noexcept = default;
+
+        // there is no way to safely implement these with concurrent access
+        seqlock_exchange_channel(seqlock_exchange_channel const &other) = delete;
+        seqlock_exchange_channel(seqlock_exchange_channel &&other) = delete;
+        seqlock_exchange_channel &operator=(seqlock_exchange_channel const &other) = delete;
+        seqlock_exchange_channel &operator=(seqlock_exchange_channel &&other) noexcept = delete;
+
+        ~seqlock_exchange_channel() noexcept = default;
+
+        /**
+         * Close the channel.
+         * After calling close calls to push() will return false
+         * and calls to try_pop will return std::nullopt once the last value was consumed
+         */
+        void close() noexcept {
+            closed_.test_and_set(std::memory_order_release);
+            has_value_.unpark_all(park_mutex_);
+            select_waiters_.notify_all();
+        }
+
+        /**
+         * @return true if this channel is closed
+         */
+        [[nodiscard]] bool closed() const noexcept {
+            return closed_.test(std::memory_order_acquire);
+        }
+
+        /**
+         * @return true if this channel is closed and the last value was consumed, i.e. no value will ever be available again
+         */
+        [[nodiscard]] bool drained() const noexcept {
+            return closed() && !has_unconsumed_value(load_stable_state());
+        }
+
+        /**
+         * Push a single element into the channel, replaces the current element in the channel if there is one.
+         * Concurrent writers are serialized by spinning, readers never delay writers.
+         *
+         * @param value the element to push
+         * @return true if pushing the element succeeded because the channel is not yet closed
+         */
+        bool push(value_type const &value) noexcept {
+            if (closed_.test(std::memory_order_acquire)) [[unlikely]] {
+                return false;
+            }
+
+            auto state = state_.load(std::memory_order_relaxed);
+            while (true) {
+                if (state & writing_bit) [[unlikely]] {
+                    detail_channel::cpu_relax();
+                    state = state_.load(std::memory_order_relaxed);
+                    continue;
+                }
+
+                if (state_.compare_exchange_weak(state, state | writing_bit, std::memory_order_acquire, std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            // readers that observe any of the following stores to words_ also observe the writing bit
+            std::atomic_thread_fence(std::memory_order_release);
+
+            store_value(value);
+
+            // new sequence number, the value is not consumed yet
+            state_.store((state & ~(writing_bit | consumed_bit)) + sequence_one, std::memory_order_release);
+
+            has_value_.unpark(park_mutex_);
+            select_waiters_.notify_all();
+            return true;
+        }
+
+        /**
+         * Construct an element and push it into the channel, replaces the current element in the channel if there is one.
+         * @see push
+         */
+        template<typename... Args>
+        bool emplace(Args &&...args) noexcept(std::is_nothrow_constructible_v<value_type, decltype(std::forward<Args>(args))...>) {
+            return push(value_type(std::forward<Args>(args)...));
+        }
+
+        /**
+         * Read the latest value without consuming it. Does not block.
+         *
+         * @return the latest value, or std::nullopt if nothing was pushed yet
+         * @note the value may already have been consumed by another thread
+         */
+        [[nodiscard]] std::optional<value_type> try_peek() const noexcept {
+            while (true) {
+                auto const state = load_stable_state();
+                if (state < sequence_one) {
+                    return std::nullopt;
+                }
+
+                auto value = load_value();
+
+                // the consumed bit does not affect the value, only the sequence number and writing bit need to be the same
+                if ((state_.load(std::memory_order_relaxed) | consumed_bit) == (state | consumed_bit)) [[likely]] {
+                    return value;
+                }
+            }
+        }
+
+        /**
+         * Try to get (and consume) a (previously pushed) element from the channel.
+         * Unlike pop(), if there is no element available, returns std::nullopt immediately.
+         */
+        [[nodiscard]] std::optional<value_type> try_pop() noexcept {
+            auto state = load_stable_state();
+            while (true) {
+                if (!has_unconsumed_value(state)) {
+                    return std::nullopt;
+                }
+
+                auto value = load_value();
+
+                // succeeds only if there was no writer in the meantime (so value is not torn) and no other consumer consumed it
+                if (state_.compare_exchange_strong(state, state | consumed_bit, std::memory_order_relaxed, std::memory_order_acquire)) [[likely]] {
+                    return value;
+                }
+
+                if (state & writing_bit) {
+                    state = load_stable_state();
+                }
+            }
+        }
+
+        /**
+         * Try to get (and consume) a (previously pushed) element from the channel.
+         * If there is no element available, blocks until there is one available or the channel is closed.
+         *
+         * @return std::nullopt if the channel was closed, an element otherwise
+         */
+        [[nodiscard]] std::optional<value_type> pop() noexcept {
+            while (true) {
+                if (auto value = try_pop(); value.has_value()) {
+                    return value;
+                }
+
+                if (closed()) [[unlikely]] {
+                    // the last value may have been pushed right before closing
+                    return try_pop();
+                }
+
+                has_value_.park(park_mutex_, [this]() noexcept {
+                    return has_unconsumed_value(state_.load(std::memory_order_acquire)) || closed();
+                });
+            }
+        }
+
+        /**
+         * Try to get (and consume) a (previously pushed) element from the channel.
+         * If there is no element available, blocks until there is one available, the channel is closed or deadline has passed.
+         *
+         * @param deadline point in time after which to give up
+         * @return an element, or channel_error::closed if the channel was closed or channel_error::timeout if there was no element until deadline
+         */
+        template<typename Clock, typename Duration>
+        [[nodiscard]] std::expected<value_type, channel_error> pop_until(std::chrono::time_point<Clock, Duration> const &deadline) noexcept {
+            while (true) {
+                if (auto value = try_pop(); value.has_value()) {
+                    return *value;
+                }
+
+                if (closed()) [[unlikely]] {
+                    if (auto value = try_pop(); value.has_value()) {
+                        return *value;
+                    }
+                    return std::unexpected{channel_error::closed};
+                }
+
+                auto const has_value = has_value_.park_until(park_mutex_, deadline, [this]() noexcept {
+                    return has_unconsumed_value(state_.load(std::memory_order_acquire)) || closed();
+                });
+
+                if (!has_value) {
+                    return std::unexpected{channel_error::timeout};
+                }
+            }
+        }
+
+        /**
+         * Try to get (and consume) a (previously pushed) element from the channel.
+         * If there is no element available, blocks until there is one available, the channel is closed or timeout has elapsed.
+         *
+         * @param timeout maximum duration to wait for an element
+         * @return an element, or channel_error::closed if the channel was closed or channel_error::timeout if there was no element in time
+         */
+        template<typename Rep, typename Period>
+        [[nodiscard]] std::expected<value_type, channel_error> pop_for(std::chrono::duration<Rep, Period> const &timeout) noexcept {
+            return pop_until(std::chrono::steady_clock::now() + timeout);
+        }
+
+        using iterator = detail_channel::channel_iterator<seqlock_exchange_channel>;
+        using sentinel = std::default_sentinel_t;
+
+        /**
+         * @return an iterator over all present and future values of the channel (that are not overwritten before they are consumed)
+         * @note iterator == end() is true once the channel is closed and the last value was consumed
+         */
+        [[nodiscard]] iterator begin() noexcept {
+            return iterator{this};
+        }
+
+        [[nodiscard]] sentinel end() const noexcept {
+            return std::default_sentinel;
+        }
+    };
+
+} // namespace dice::template_library
+
+#endif // DICE_TEMPLATELIBRARY_SEQLOCKEXCHANGECHANNEL_HPP
@@ -0,0 +1,476 @@
+#ifndef DICE_TEMPLATELIBRARY_SHARDEDCHANNEL_HPP
+#define DICE_TEMPLATELIBRARY_SHARDEDCHANNEL_HPP
+
+#include <dice/template-library/channel.hpp>
+#include <dice/template-library/vec_deque.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace dice::template_library {
+
+    namespace detail_sharded_channel {
+        /**
+         * @return a per-thread value that is used to pick the home shard of a consumer and the starting shard of a producer
+         */
+        inline size_t thread_shard_hint() noexcept {
+            static thread_local size_t const hint = std::hash<std::thread::id>{}(std::this_thread::get_id());
+            return hint;
+        }
+
+        /**
+         * @return a per-thread value that changes on every call, used to distribute the elements of a producer round-robin over the shards
+         */
+        inline size_t next_producer_shard_hint() noexcept {
+            static thread_local size_t counter = thread_shard_hint();
+            return counter++;
+        }
+    } // namespace detail_sharded_channel
+
+    /**
+     * A multi producer, multi consumer channel/queue that is split into multiple independently locked shards.
+     *
+     * Producers distribute their elements round-robin over the shards (or into a shard picked by the caller, see emplace_at).
+     * Each consumer has a home shard it pops from, if that is empty it steals from the other shards before it blocks.
+     * Consumers therefore (mostly) contend only with the producers, not with each other.
+     *
+     * Elements are only delivered in FIFO order per shard, not across the whole channel.
+     * Like channel, once close() was called pushing fails and the remaining elements of all shards can still be popped.
+     *
+     * @warning close() must be called once the producing threads are done, otherwise the reading thread will hang indefinitely
+     *
+     * @tparam T value type of the channel
+     */
+    template<typename T>
+    struct sharded_channel {
+        using value_type = T;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = value_type &;
+        using const_reference = value_type const &;
+        using pointer = T *;
+        using const_pointer = T const *;
+
+    private:
+        struct alignas(detail_channel::cache_line_size) shard {
+            std::mutex mutex_; ///< mutex for queue_
+            vec_deque<T> queue_; ///< queue for the elements of this shard
+            std::atomic<size_t> size_ = 0; ///< queue_.size(), readable without holding mutex_
+        };
+
+        size_t n_shards_; ///< number of elements in shards_
+        size_t shard_cap_; ///< maximum allowed number of elements per shard
+        std::unique_ptr<shard[]> shards_;
+
+        // everything below is only touched if a thread needs to block or the channel is closed
+        alignas(detail_channel::cache_line_size) std::atomic_flag closed_ = ATOMIC_FLAG_INIT; ///< true if this channel is closed
+        std::mutex park_mutex_; ///< mutex for queue_not_empty_ and queue_not_full_
+        detail_channel::parking_spot queue_not_empty_; ///< consumers wait for "there is an element in any shard or the channel is closed"
+        detail_channel::parking_spot queue_not_full_; ///< producers wait for "there is a free slot in any shard or the channel is closed"
+
+        enum struct op_result : uint8_t {
+            success,
+            would_block,
+            closed,
+        };
+
+        /**
+         * Try to emplace an element into the first shard with free capacity, starting at shard_hint
+         */
+        template<typename ...Args>
+        op_result try_emplace_impl(size_t shard_hint, Args &&...args) noexcept(std::is_nothrow_constructible_v<value_type, decltype(std::forward<Args>(args))...>) {
+            for (size_t ix = 0; ix < n_shards_; ++ix) {
+                auto &s = shards_[(shard_hint + ix) % n_shards_];
+                if (s.size_.load(std::memory_order_relaxed) >= shard_cap_) {
+                    // skip full shards without locking them
+                    continue;
+                }
+
+                std::lock_guard lock{s.mutex_};
+                if (closed_.test(std::memory_order_relaxed)) [[unlikely]] {
+                    // relaxed is enough because close() locks every shard
+                    return op_result::closed;
+                }
+
+                if (s.queue_.size() < shard_cap_) {
+                    s.queue_.emplace_back(std::forward<Args>(args)...);
+                    s.size_.store(s.queue_.size(), std::memory_order_relaxed);
+                    return op_result::success;
+                }
+            }
+
+            return op_result::would_block;
+        }
+
+        /**
+         * Try to pop an element from the first non-empty shard, starting at home_shard
+         */
+        std::optional<value_type> try_pop_impl(size_t home_shard) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            for (size_t ix = 0; ix < n_shards_; ++ix) {
+                auto &s = shards_[(home_shard + ix) % n_shards_];
+                if (s.size_.load(std::memory_order_relaxed) == 0) {
+                    // skip empty shards without locking them
+                    continue;
+                }
+
+                std::lock_guard lock{s.mutex_};
+                if (!s.queue_.empty()) {
+                    std::optional<value_type> ret{std::move(s.queue_.front())};
+                    s.queue_.pop_front();
+                    s.size_.store(s.queue_.size(), std::memory_order_relaxed);
+                    return ret;
+                }
+            }
+
+            return std::nullopt;
+        }
+
+        template<typename ...Args>
+        bool emplace_impl(size_t shard_hint, Args &&...args) noexcept(std::is_nothrow_constructible_v<value_type, decltype(std::forward<Args>(args))...>) {
+            while (true) {
+                if (closed_.test(std::memory_order_relaxed)) [[unlikely]] {
+                    return false;
+                }
+
+                // note: args are only consumed if try_emplace_impl succeeds, so it is fine to forward them in a loop
+                switch (try_emplace_impl(shard_hint, std::forward<Args>(args)...)) {
+                    case op_result::success: {
+                        queue_not_empty_.unpark(park_mutex_);
+                        return true;
+                    }
+                    case op_result::closed: {
+                        return false;
+                    }
+                    case op_result::would_block: {
+                        queue_not_full_.park(park_mutex_, [this]() noexcept { return writable_or_closed(); });
+                        break;
+                    }
+                }
+            }
+        }
+
+        template<typename ...Args>
+        bool try_emplace_at_impl(size_t shard_hint, Args &&...args) noexcept(std::is_nothrow_constructible_v<value_type, decltype(std::forward<Args>(args))...>) {
+            if (closed_.test(std::memory_order_relaxed)) [[unlikely]] {
+                return false;
+            }
+
+            if (try_emplace_impl(shard_hint, std::forward<Args>(args)...) != op_result::success) {
+                return false;
+            }
+
+            queue_not_empty_.unpark(park_mutex_);
+            return true;
+        }
+
+        /**
+         * @return true if there is at least one free slot in any shard or the channel is closed
+         */
+        [[nodiscard]] bool writable_or_closed() const noexcept {
+            for (size_t ix = 0; ix < n_shards_; ++ix) {
+                if (shards_[ix].size_.load(std::memory_order_relaxed) < shard_cap_) {
+                    return true;
+                }
+            }
+            return closed_.test(std::memory_order_acquire);
+        }
+
+        /**
+         * @return true if there is at least one element in any shard or the channel is closed
+         */
+        [[nodiscard]] bool readable_or_closed() const noexcept {
+            for (size_t ix = 0; ix < n_shards_; ++ix) {
+                if (shards_[ix].size_.load(std::memory_order_relaxed) > 0) {
+                    return true;
+                }
+            }
+            return closed_.test(std::memory_order_acquire);
+        }
+
+    public:
+        /**
+         * A consumer that is bound to a fixed home shard
+         */
+        struct consumer_handle {
+            using value_type = T;
+            using pointer = T *;
+            using const_pointer = T const *;
+
+        private:
+            sharded_channel *chan_;
+            size_t home_shard_;
+
+        public:
+            consumer_handle(sharded_channel &chan, size_t home_shard) noexcept : chan_{&chan},
+                                                                                home_shard_{home_shard} {
+            }
+
+            /**
+             * @see sharded_channel::pop(size_t)
+             */
+            [[nodiscard]] std::optional<value_type> pop() noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+                return chan_->pop(home_shard_);
+            }
+
+            /**
+             * @see sharded_channel::try_pop(size_t)
+             */
+            [[nodiscard]] std::optional<value_type> try_pop() noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+                return chan_->try_pop(home_shard_);
+            }
+
+            using iterator = detail_channel::channel_iterator<consumer_handle>;
+            using sentinel = std::default_sentinel_t;
+
+            /**
+             * @return an iterator over all present and future elements of the channel, popped via this consumer
+             * @note iterator == end() is true once the channel is closed
+             */
+            [[nodiscard]] iterator begin() noexcept {
+                return iterator{this};
+            }
+
+            [[nodiscard]] sentinel end() const noexcept {
+                return std::default_sentinel;
+            }
+        };
+
+        /**
+         * @param n_shards number of shards, usually the number of consumers, must be greater than 0
+         * @param shard_capacity maximum number of elements each shard can hold, must be greater than 0
+         * @note memory for all elements is allocated up front, the channel does not allocate after construction
+         */
+        sharded_channel(size_t n_shards, size_t shard_capacity) : n_shards_{n_shards},
+                                                                  shard_cap_{shard_capacity},
+                                                                  shards_{std::make_unique<shard[]>(n_shards)} {
+            assert(n_shards > 0);
+            assert(shard_capacity > 0);
+
+            for (size_t ix = 0; ix < n_shards_; ++ix) {
+                shards_[ix].queue_.reserve(shard_cap_);
+            }
+        }
+
+        // there is no way to safely implement these with concurrent access
+        sharded_channel(sharded_channel const &other) = delete;
+        sharded_channel(sharded_channel &&other) = delete;
+        sharded_channel &operator=(sharded_channel const &other) = delete;
+        sharded_channel &operator=(sharded_channel &&other) noexcept = delete;
+
+        ~sharded_channel() noexcept = default;
+
+        /**
+         * @return the number of shards of this channel
+         */
+        [[nodiscard]] size_t n_shards() const noexcept {
+            return n_shards_;
+        }
+
+        /**
+         * Close the channel.
+         * After calling close calls to push() will return false
+         * and calls to try_pop will return std::nullopt once the already present elements (of all shards) are exhausted
+         */
+        void close() noexcept {
+            // lock all shards, so that every push either completes before closed_ is set or observes closed_
+            for (size_t ix = 0; ix < n_shards_; ++ix) {
+                shards_[ix].mutex_.lock();
+            }
+            closed_.test_and_set(std::memory_order_seq_cst);
+            for (size_t ix = 0; ix < n_shards_; ++ix) {
+                shards_[ix].mutex_.unlock();
+            }
+
+            queue_not_empty_.unpark_all(park_mutex_); // notify pop() so that it does not get stuck
+            queue_not_full_.unpark_all(park_mutex_); // notify emplace()
+        }
+
+        /**
+         * @return true if this channel is closed
+         */
+        [[nodiscard]] bool closed() const noexcept {
+            return closed_.test(std::memory_order_acquire);
+        }
+
+        /**
+         * Emplace an element into the channel, blocks if there is no capacity left in any shard.
+         * The shards are tried round-robin (per producing thread).
+         *
+         * @param args constructor args
+         * @return true if emplacing the element succeeded because the channel is not yet closed
+         */
+        template<typename ...Args>
+        bool emplace(Args &&...args) noexcept(std::is_nothrow_constructible_v<value_type, decltype(std::forward<Args>(args))...>) {
+            return emplace_impl(detail_sharded_channel::next_producer_shard_hint(), std::forward<Args>(args)...);
+        }
+
+        /**
+         * Emplace an element into the channel, starting the search for a shard with free capacity at shard_hint % n_shards().
+         * Blocks if there is no capacity left in any shard.
+         *
+         * @param shard_hint the preferred shard, e.g. a hash of the element to keep related elements together
+         * @param args constructor args
+         * @return true if emplacing the element succeeded because the channel is not yet closed
+         */
+        template<typename ...Args>
+        bool emplace_at(size_t shard_hint, Args &&...args) noexcept(std::is_nothrow_constructible_v<value_type, decltype(std::forward<Args>(args))...>) {
+            return emplace_impl(shard_hint, std::forward<Args>(args)...);
+        }
+
+        /**
+         * Emplace an element into the channel, returns immediately if there is no capacity in any shard.
+         *
+         * @param args constructor args
+         * @return true if emplacing the element succeeded
+         */
+        template<typename ...Args>
+        bool try_emplace(Args &&...args) noexcept(std::is_nothrow_constructible_v<value_type, decltype(std::forward<Args>(args))...>) {
+            return try_emplace_at_impl(detail_sharded_channel::next_producer_shard_hint(), std::forward<Args>(args)...);
+        }
+
+        /**
+         * Emplace an element into the channel, starting the search for a shard with free capacity at shard_hint % n_shards().
+         * Returns immediately if there is no capacity in any shard.
+         *
+         * @param shard_hint the preferred shard, e.g. a hash of the element to keep related elements together
+         * @param args constructor args
+         * @return true if emplacing the element succeeded
+         */
+        template<typename ...Args>
+        bool try_emplace_at(size_t shard_hint, Args &&...args) noexcept(std::is_nothrow_constructible_v<value_type, decltype(std::forward<Args>(args))...>) {
+            return try_emplace_at_impl(shard_hint, std::forward<Args>(args)...);
+        }
+
+        /**
+         * Push a single element into the channel, blocks if there is no capacity left in any shard.
+         *
+         * @param value the element to push
+         * @return true if pushing the element succeeded because the channel is not yet closed
+         */
+        bool push(value_type const &value) noexcept(std::is_nothrow_copy_constructible_v<value_type>) {
+            return emplace(value);
+        }
+
+        /**
+         * Push a single element into the channel, returns immediately if there is no capacity in any shard.
+         *
+         * @param value the element to push
+         * @return true if pushing the element succeeded because the channel is not yet closed
+         */
+        bool try_push(value_type const &value) noexcept(std::is_nothrow_copy_constructible_v<value_type>) {
+            return try_emplace(value);
+        }
+
+        /**
+         * Push a single element into the channel, blocks if there is no capacity left in any shard.
+         *
+         * @param value the element to push
+         * @return true if pushing the element succeeded because the channel is not yet closed
+         */
+        bool push(value_type &&value) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            return emplace(std::move(value));
+        }
+
+        /**
+         * Push a single element into the channel, returns immediately if there is no capacity in any shard.
+         *
+         * @param value the element to push
+         * @return true if pushing the element succeeded because the channel is not yet closed
+         */
+        bool try_push(value_type &&value) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            return try_emplace(std::move(value));
+        }
+
+        /**
+         * Try to get a (previously pushed) element from the channel.
+         * Pops from the home shard (home_shard % n_shards()) first, then steals from the other shards.
+         * If there is no element available in any shard, blocks until there is one available or the channel is closed.
+         *
+         * @param home_shard the shard of the calling consumer
+         * @return std::nullopt if the channel was closed, an element otherwise
+         */
+        [[nodiscard]] std::optional<value_type> pop(size_t home_shard) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            while (true) {
+                // closed_ must be read before the shards are checked, no element can be pushed after it was set
+                auto const closed = closed_.test(std::memory_order_acquire);
+
+                if (auto ret = try_pop(home_shard); ret.has_value()) {
+                    return ret;
+                }
+
+                if (closed) [[unlikely]] {
+                    return std::nullopt;
+                }
+
+                queue_not_empty_.park(park_mutex_, [this]() noexcept { return readable_or_closed(); });
+            }
+        }
+
+        /**
+         * Try to get a (previously pushed) element from the channel.
+         * The home shard is derived from the id of the calling thread, see pop(size_t).
+         *
+         * @return std::nullopt if the channel was closed, an element otherwise
+         */
+        [[nodiscard]] std::optional<value_type> pop() noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            return pop(detail_sharded_channel::thread_shard_hint());
+        }
+
+        /**
+         * Try to get a (previously pushed) element from the channel.
+         * Unlike pop(), if there is no element available in any shard, returns std::nullopt immediatly.
+         *
+         * @param home_shard the shard of the calling consumer
+         */
+        [[nodiscard]] std::optional<value_type> try_pop(size_t home_shard) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            auto ret = try_pop_impl(home_shard);
+            if (ret.has_value()) {
+                queue_not_full_.unpark(park_mutex_);
+            }
+            return ret;
+        }
+
+        /**
+         * Try to get a (previously pushed) element from the channel.
+         * Unlike pop(), if there is no element available in any shard, returns std::nullopt immediatly.
+         */
+        [[nodiscard]] std::optional<value_type> try_pop() noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            return try_pop(detail_sharded_channel::thread_shard_hint());
+        }
+
+        /**
+         * @param home_shard the shard the consumer pops from first
+         * @return a consumer that pops from home_shard first and can be iterated
+         */
+        [[nodiscard]] consumer_handle consumer(size_t home_shard) noexcept {
+            return consumer_handle{*this, home_shard};
+        }
+
+        using iterator = detail_channel::channel_iterator<sharded_channel>;
+        using sentinel = std::default_sentinel_t;
+
+        /**
+         * @return an iterator over all present and future elements of this channel, the home shard is derived from the id of the calling thread
+         * @note iterator == end() is true once the channel is closed
+         */
+        [[nodiscard]] iterator begin() noexcept {
+            return iterator{this};
+        }
+
+        [[nodiscard]] sentinel end() const noexcept {
+            return std::default_sentinel;
+        }
+    };
+
+} // namespace dice::template_library
+
+#endif // DICE_TEMPLATELIBRARY_SHARDEDCHANNEL_HPP
@@ -1,6 +1,8 @@
 #ifndef DICE_TEMPLATELIBRARY_SHAREDMUTEX_HPP
 #define DICE_TEMPLATELIBRARY_SHAREDMUTEX_HPP
 
+#include <dice/template-library/upgrade_mutex.hpp>
+
 #include <mutex>
 #include <shared_mutex>
 #include <optional>
@@ -9,9 +11,16 @@
 
 namespace dice::template_library {
 
+    namespace detail_lock_all {
+        struct lock_access;
+    } // namespace detail_lock_all
+
     template<typename T, typename Mutex = std::shared_mutex>
     struct shared_mutex;
 
+    template<typename T, typename Mutex>
+    struct shared_mutex_upgradable_guard;
+
 	/**
      * An RAII guard for a value behind a shared_mutex.
      * When this shared_mutex_guard is dropped the lock is automatically released.
@@ -31,6 +40,9 @@ namespace dice::template_library {
 
     private:
         friend struct shared_mutex<std::remove_const_t<T>, Mutex>;
+        friend struct shared_mutex_guard<std::remove_const_t<T>, Mutex>;
+        friend struct shared_mutex_upgradable_guard<std::remove_const_t<T>, Mutex>;
+        friend struct detail_lock_all::lock_access;
 
         value_type *value_ptr_;
         lock_type lock_;
@@ -56,6 +68,18 @@ namespace dice::template_library {
             return *value_ptr_;
         }
 
+        /**
+         * Atomically convert this exclusive guard into a shared guard, i.e. without allowing other writers to lock the mutex in between.
+         * This guard is invalidated.
+         *
+         * @return shared guard for the same value
+         */
+        [[nodiscard]] shared_mutex_guard<T const, Mutex> downgrade() && requires (!std::is_const_v<T> && downgrade_lockable<Mutex>) {
+            auto *mutex = lock_.release();
+            mutex->unlock_and_lock_shared();
+            return shared_mutex_guard<T const, Mutex>{std::shared_lock<mutex_type>{*mutex, std::adopt_lock}, *value_ptr_};
+        }
+
         friend void swap(shared_mutex_guard const &lhs, shared_mutex_guard const &rhs) noexcept {
             using std::swap;
             swap(lhs.value_ptr_, rhs.value_ptr_);
@@ -63,6 +87,82 @@ namespace dice::template_library {
         }
     };
 
+	/**
+     * An RAII guard for a value behind a shared_mutex, holding upgradable ownership of the mutex.
+     * It only allows read access and coexists with shared guards, but can be atomically upgraded to an exclusive guard via upgrade().
+     * When this guard is dropped the lock is automatically released.
+     *
+     * @note see shared_mutex_guard for the restrictions on using the pointers and references given out by this type
+     *
+     * @tparam T the value type protected by the mutex
+     * @tparam Mutex the mutex type, see upgrade_lockable
+     */
+    template<typename T, typename Mutex>
+    struct shared_mutex_upgradable_guard {
+        using value_type = T const;
+        using mutex_type = Mutex;
+
+    private:
+        friend struct shared_mutex<T, Mutex>;
+
+        T *value_ptr_;
+        mutex_type *mutex_; ///< the mutex this guard holds upgradable ownership of, nullptr if moved-from
+
+        shared_mutex_upgradable_guard(mutex_type &mutex, T &value) noexcept
+            : value_ptr_{&value},
+              mutex_{&mutex} {
+        }
+
+        void release() noexcept {
+            if (mutex_ != nullptr) {
+                std::exchange(mutex_, nullptr)->unlock_upgrade();
+            }
+        }
+
+    public:
+        shared_mutex_upgradable_guard() = delete;
+        shared_mutex_upgradable_guard(shared_mutex_upgradable_guard const &other) noexcept = delete;
+        shared_mutex_upgradable_guard &operator=(shared_mutex_upgradable_guard const &other) noexcept = delete;
+
+        shared_mutex_upgradable_guard(shared_mutex_upgradable_guard &&other) noexcept
+            : value_ptr_{other.value_ptr_},
+              mutex_{std::exchange(other.mutex_, nullptr)} {
+        }
+
+        shared_mutex_upgradable_guard &operator=(shared_mutex_upgradable_guard &&other) noexcept {
+            if (this != &other) {
+                release();
+                value_ptr_ = other.value_ptr_;
+                mutex_ = std::exchange(other.mutex_, nullptr);
+            }
+            return *this;
+        }
+
+        ~shared_mutex_upgradable_guard() {
+            release();
+        }
+
+        value_type *operator->() const noexcept {
+            return value_ptr_;
+        }
+
+        value_type &operator*() const noexcept {
+            return *value_ptr_;
+        }
+
+        /**
+         * Atomically convert this guard into an exclusive guard, i.e. without allowing other writers to lock the mutex in between.
+         * Blocks until all shared guards are released. This guard is invalidated.
+         *
+         * @return exclusive guard for the same value
+         */
+        [[nodiscard]] shared_mutex_guard<T, Mutex> upgrade() && {
+            auto *mutex = std::exchange(mutex_, nullptr);
+            mutex->unlock_upgrade_and_lock();
+            return shared_mutex_guard<T, Mutex>{std::unique_lock<mutex_type>{*mutex, std::adopt_lock}, *value_ptr_};
+        }
+    };
+
 	/**
      * A rust-like shared_mutex type (https://doc.rust-lang.org/std/sync/struct.RwLock.html) that holds its data instead of living next to it.
      *
@@ -78,6 +178,8 @@ namespace dice::template_library {
         using mutex_type = Mutex;
 
     private:
+        friend struct detail_lock_all::lock_access;
+
         value_type value_;
         mutable mutex_type mutex_;
 
@@ -110,8 +212,8 @@ namespace dice::template_library {
          * @return mutex guard for the inner value
          * @throws std::system_error in case the underlying mutex implementation throws it
          */
-        [[nodiscard]] shared_mutex_guard<value_type> lock() {
-            return shared_mutex_guard<value_type>{std::unique_lock<mutex_type>{mutex_}, value_};
+        [[nodiscard]] shared_mutex_guard<value_type, mutex_type> lock() {
+            return shared_mutex_guard<value_type, mutex_type>{std::unique_lock<mutex_type>{mutex_}, value_};
         }
 
 		/**
@@ -121,13 +223,13 @@ namespace dice::template_library {
          * @return nullopt in case the mutex could not be locked, otherwise a mutex guard for the inner value
          * @throws std::system_error in case the underlying mutex implementation throws it
          */
-        [[nodiscard]] std::optional<shared_mutex_guard<value_type>> try_lock() {
+        [[nodiscard]] std::optional<shared_mutex_guard<value_type, mutex_type>> try_lock() {
             std::unique_lock<mutex_type> lock{mutex_, std::try_to_lock};
             if (!lock.owns_lock()) {
                 return std::nullopt;
             }
 
-            return shared_mutex_guard<value_type>{std::move(lock), value_};
+            return shared_mutex_guard<value_type, mutex_type>{std::move(lock), value_};
         }
 
         /**
@@ -137,8 +239,8 @@ namespace dice::template_library {
          * @return mutex guard for the inner value
          * @throws std::system_error in case the underlying mutex implementation throws it
          */
-        [[nodiscard]] shared_mutex_guard<value_type const> lock_shared() const {
-            return shared_mutex_guard<value_type const>{std::shared_lock<mutex_type>{mutex_}, value_};
+        [[nodiscard]] shared_mutex_guard<value_type const, mutex_type> lock_shared() const {
+            return shared_mutex_guard<value_type const, mutex_type>{std::shared_lock<mutex_type>{mutex_}, value_};
         }
 
         /**
@@ -148,13 +250,40 @@ namespace dice::template_library {
          * @return nullopt in case the mutex could not be locked, otherwise a mutex guard for the inner value
          * @throws std::system_error in case the underlying mutex implementation throws it
          */
-        [[nodiscard]] std::optional<shared_mutex_guard<value_type const>> try_lock_shared() const {
+        [[nodiscard]] std::optional<shared_mutex_guard<value_type const, mutex_type>> try_lock_shared() const {
             std::shared_lock<mutex_type> lock{mutex_, std::try_to_lock};
             if (!lock.owns_lock()) {
                 return std::nullopt;
             }
 
-            return shared_mutex_guard<value_type const>{std::move(lock), value_};
+            return shared_mutex_guard<value_type const, mutex_type>{std::move(lock), value_};
+        }
+
+        /**
+         * Lock the mutex for upgradable ownership and return a guard that will keep it locked until it goes out of scope and
+         * allows read access to the inner value. Coexists with shared guards, but only one upgradable guard can exist at a time.
+         * The guard can be atomically upgraded to an exclusive guard, which allows for check-then-modify without racing other writers.
+         *
+         * @return upgradable guard for the inner value
+         * @throws std::system_error in case the underlying mutex implementation throws it
+         */
+        [[nodiscard]] shared_mutex_upgradable_guard<value_type, mutex_type> lock_upgradable() requires (upgrade_lockable<mutex_type>) {
+            mutex_.lock_upgrade();
+            return shared_mutex_upgradable_guard<value_type, mutex_type>{mutex_, value_};
+        }
+
+        /**
+         * Attempt to lock the mutex for upgradable ownership, see lock_upgradable().
+         *
+         * @return nullopt in case the mutex could not be locked, otherwise an upgradable guard for the inner value
+         * @throws std::system_error in case the underlying mutex implementation throws it
+         */
+        [[nodiscard]] std::optional<shared_mutex_upgradable_guard<value_type, mutex_type>> try_lock_upgradable() requires (upgrade_lockable<mutex_type>) {
+            if (!mutex_.try_lock_upgrade()) {
+                return std::nullopt;
+            }
+
+            return shared_mutex_upgradable_guard<value_type, mutex_type>{mutex_, value_};
         }
     };
 
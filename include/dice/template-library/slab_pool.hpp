@@ -0,0 +1,428 @@
+#ifndef DICE_TEMPLATELIBRARY_SLABPOOL_HPP
+#define DICE_TEMPLATELIBRARY_SLABPOOL_HPP
+
+#if __has_include(<sys/mman.h>)
+#include <sys/mman.h>
+#endif
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <new>
+
+namespace dice::template_library {
+
+    /**
+     * Runtime configuration of a slab_pool (and of each bucket of a pool)
+     */
+    struct pool_config {
+        /**
+         * Number of chunks (allocations) that the first memory allocation of the pool should at least provide.
+         * This also determines the size of the slabs: they are large enough for this many chunks (rounded up to a power of two),
+         * but at least one page (4 KiB) and at most max_block_bytes large.
+         */
+        size_t initial_block_chunks = 32;
+
+        /**
+         * Each time the pool runs out of chunks, it allocates growth_factor times as many slabs as the last time (must be >= 1)
+         */
+        double growth_factor = 2.0;
+
+        /**
+         * Maximum number of bytes (of slabs) that are allocated at once when the pool runs out of chunks.
+         * At least one slab is always allocated.
+         */
+        size_t max_block_bytes = std::numeric_limits<size_t>::max();
+
+        /**
+         * Back the memory of the pool with transparent huge pages, i.e. make the slabs at least as large as a huge page (2 MiB),
+         * and advise the kernel to use huge pages for them (only on linux, a no-op elsewhere).
+         * This reduces TLB misses for large pools.
+         */
+        bool huge_pages = false;
+
+        /**
+         * Maximum number of unused chunks the pool keeps before it returns slabs without live allocations back to the system
+         * (see slab_pool::release_unused()). By default, memory is never returned automatically.
+         * To avoid freeing and re-allocating a slab over and over, trimming only starts once there are more than
+         * max_free_chunks plus one slab worth of unused chunks, and then trims down to max_free_chunks.
+         * Note: while there are live allocations, recently deallocated chunks that are cached for reuse keep their slabs alive.
+         */
+        size_t max_free_chunks = std::numeric_limits<size_t>::max();
+    };
+
+    namespace detail_slab_pool {
+        inline constexpr size_t page_size = size_t{4} * 1024;
+        inline constexpr size_t huge_page_size = size_t{2} * 1024 * 1024;
+        inline constexpr size_t max_slab_size = std::bit_floor(std::numeric_limits<size_t>::max());
+        inline constexpr size_t min_chunks_per_slab = 8; ///< slabs are always large enough to hold this many chunks
+    } // namespace detail_slab_pool
+
+    /**
+     * A memory pool for chunks of a single (runtime) size.
+     *
+     * Chunks are carved out of slabs, which are blocks of memory that are aligned to their (power of two) size.
+     * Each slab has a small header with its own intrusive free list and number of live chunks,
+     * so deallocating a chunk is O(1): its slab is found by masking the address of the chunk.
+     * Slabs without live allocations can be returned to the system individually (see release_unused() and pool_config::max_free_chunks),
+     * chunks are only touched once they are allocated for the first time.
+     * Recently deallocated chunks are kept in a small pool-wide cache (at most one slab worth of chunks) and are handed out again first,
+     * so that hot memory is reused and the common case does not need to touch the slab header at all.
+     *
+     * This is not thread-safe.
+     * @note This type is non-movable and non-copyable, if you need to do either of these things use `std::unique_ptr<slab_pool>` or `std::shared_ptr<slab_pool>`
+     */
+    struct slab_pool {
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+
+    private:
+        struct slab {
+            slab *prev = nullptr;
+            slab *next = nullptr;
+            void *free_list = nullptr; ///< chunks that were deallocated
+            std::byte *unused_begin; ///< start of the chunks that were never allocated
+            size_t n_live = 0; ///< number of chunks in this slab that are currently allocated
+        };
+
+        /**
+         * Intrusive doubly linked list of slabs
+         */
+        struct slab_list {
+            slab *head = nullptr;
+
+            void push_front(slab *s) noexcept {
+                s->prev = nullptr;
+                s->next = head;
+                if (head != nullptr) {
+                    head->prev = s;
+                }
+                head = s;
+            }
+
+            void erase(slab *s) noexcept {
+                if (s->prev != nullptr) {
+                    s->prev->next = s->next;
+                } else {
+                    head = s->next;
+                }
+
+                if (s->next != nullptr) {
+                    s->next->prev = s->prev;
+                }
+            }
+        };
+
+        static constexpr size_t header_size = (sizeof(slab) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+        size_t chunk_size_; ///< size of the chunks, which is also their distance in a slab
+        size_t slab_size_;
+        size_t chunks_per_slab_;
+        size_t max_cached_chunks_; ///< capacity of cache_
+        size_t trim_threshold_; ///< slabs are trimmed once there are more unused chunks than this, see pool_config::max_free_chunks
+        pool_config config_;
+
+        size_t initial_refill_slabs_; ///< number of slabs allocated the first time the pool runs out of chunks
+        size_t max_refill_slabs_; ///< maximum number of slabs allocated at once
+        size_t next_refill_slabs_; ///< number of slabs allocated the next time the pool runs out of chunks
+
+        slab_list available_; ///< slabs that have at least one free chunk
+        slab_list full_; ///< slabs without free chunks
+        size_t n_slabs_ = 0;
+        size_t n_live_ = 0; ///< number of chunks that are currently allocated
+
+        void *cache_ = nullptr; ///< intrusive list of recently deallocated chunks, they are still accounted as live in their slabs
+        size_t n_cached_ = 0;
+
+        [[nodiscard]] static void *next_of(void *chunk) noexcept {
+            void *next;
+            std::memcpy(&next, chunk, sizeof(next));
+            return next;
+        }
+
+        static void set_next_of(void *chunk, void *next) noexcept {
+            std::memcpy(chunk, &next, sizeof(next));
+        }
+
+        [[nodiscard]] slab *slab_of(void *chunk) const noexcept {
+            return reinterpret_cast<slab *>(reinterpret_cast<uintptr_t>(chunk) & ~(static_cast<uintptr_t>(slab_size_) - 1));
+        }
+
+        void allocate_slab() {
+            auto *ptr = static_cast<std::byte *>(std::aligned_alloc(slab_size_, slab_size_));
+            if (ptr == nullptr) [[unlikely]] {
+                throw std::bad_alloc{};
+            }
+
+#ifdef MADV_HUGEPAGE
+            if (config_.huge_pages) {
+                // this is only a hint, if the kernel does not support transparent huge pages regular pages are used
+                ::madvise(ptr, slab_size_, MADV_HUGEPAGE);
+            }
+#endif
+
+            auto *s = new (ptr) slab{.unused_begin = ptr + header_size};
+            available_.push_front(s);
+            ++n_slabs_;
+        }
+
+        void free_slab(slab *s) noexcept {
+            s->~slab();
+            std::free(s);
+
+            if (--n_slabs_ == 0) {
+                // start over, as if the pool was new
+                next_refill_slabs_ = std::min(initial_refill_slabs_, max_refill_slabs_);
+            }
+        }
+
+        /**
+         * Give a chunk back to its slab
+         */
+        void return_to_slab(void *chunk) noexcept {
+            slab *s = slab_of(chunk);
+            set_next_of(chunk, s->free_list);
+            s->free_list = chunk;
+
+            if (s->n_live-- == chunks_per_slab_) [[unlikely]] {
+                full_.erase(s);
+                available_.push_front(s);
+            }
+
+            if (s->n_live == 0 && n_free_chunks() > trim_threshold_) [[unlikely]] {
+                trim();
+            }
+        }
+
+        /**
+         * Give all cached chunks back to their slabs
+         */
+        void flush_cache() noexcept {
+            while (cache_ != nullptr) {
+                void *chunk = cache_;
+                cache_ = next_of(chunk);
+                --n_cached_;
+                return_to_slab(chunk);
+            }
+        }
+
+        /**
+         * Free slabs without live allocations until there are at most max_free_chunks unused chunks
+         */
+        void trim() noexcept {
+            for (slab *s = available_.head; s != nullptr && n_free_chunks() > config_.max_free_chunks;) {
+                slab *next = s->next;
+                if (s->n_live == 0) {
+                    available_.erase(s);
+                    free_slab(s);
+                }
+                s = next;
+            }
+        }
+
+        /**
+         * Allocate new slabs, because all existing ones are full
+         */
+        void refill() {
+            for (size_t ix = 0; ix < next_refill_slabs_; ++ix) {
+                allocate_slab();
+            }
+
+            auto const grown = static_cast<double>(next_refill_slabs_) * config_.growth_factor;
+            next_refill_slabs_ = grown >= static_cast<double>(max_refill_slabs_)
+                ? max_refill_slabs_
+                : std::max(next_refill_slabs_, static_cast<size_t>(grown));
+        }
+
+        /**
+         * @return size of the slabs for chunks of chunk_size bytes, see pool_config::initial_block_chunks
+         */
+        [[nodiscard]] static size_t slab_size_for(size_t chunk_size, pool_config const &config) noexcept {
+            using namespace detail_slab_pool;
+
+            auto const bytes_for = [chunk_size](size_t n_chunks) noexcept {
+                return n_chunks > (max_slab_size - header_size) / chunk_size ? max_slab_size : std::bit_ceil(header_size + n_chunks * chunk_size);
+            };
+
+            auto const wanted = std::min(bytes_for(config.initial_block_chunks), std::bit_floor(std::max(config.max_block_bytes, page_size)));
+            return std::max({page_size, bytes_for(min_chunks_per_slab), wanted, config.huge_pages ? huge_page_size : size_t{0}});
+        }
+
+    public:
+        /**
+         * @param chunk_size size of the chunks this pool allocates
+         * @param config configuration
+         */
+        explicit slab_pool(size_t chunk_size, pool_config const &config = {})
+            : chunk_size_{(std::max(chunk_size, sizeof(void *)) + alignof(void *) - 1) / alignof(void *) * alignof(void *)},
+              slab_size_{slab_size_for(chunk_size_, config)},
+              chunks_per_slab_{(slab_size_ - header_size) / chunk_size_},
+              max_cached_chunks_{std::min(chunks_per_slab_, config.max_free_chunks)},
+              trim_threshold_{config.max_free_chunks > std::numeric_limits<size_t>::max() - chunks_per_slab_
+                                  ? std::numeric_limits<size_t>::max()
+                                  : config.max_free_chunks + chunks_per_slab_},
+              config_{config},
+              initial_refill_slabs_{std::max<size_t>(1, (config.initial_block_chunks + chunks_per_slab_ - 1) / chunks_per_slab_)},
+              max_refill_slabs_{std::max<size_t>(1, config.max_block_bytes / slab_size_)},
+              next_refill_slabs_{std::min(initial_refill_slabs_, max_refill_slabs_)} {
+        }
+
+        slab_pool(slab_pool const &other) = delete;
+        slab_pool(slab_pool &&other) = delete;
+        slab_pool &operator=(slab_pool const &other) = delete;
+        slab_pool &operator=(slab_pool &&other) = delete;
+
+        /**
+         * Frees all memory, including live allocations
+         */
+        ~slab_pool() {
+            purge_memory();
+        }
+
+        /**
+         * @return size of the chunks of this pool (which may be larger than the size this pool was constructed with)
+         */
+        [[nodiscard]] size_t chunk_size() const noexcept {
+            return chunk_size_;
+        }
+
+        /**
+         * @return size of a slab in bytes
+         */
+        [[nodiscard]] size_t slab_size() const noexcept {
+            return slab_size_;
+        }
+
+        /**
+         * @return number of chunks that are currently allocated
+         */
+        [[nodiscard]] size_t n_live() const noexcept {
+            return n_live_;
+        }
+
+        /**
+         * @return number of chunks that are available for allocation without allocating new slabs
+         */
+        [[nodiscard]] size_t n_free_chunks() const noexcept {
+            return n_slabs_ * chunks_per_slab_ - n_live_;
+        }
+
+        /**
+         * @return number of bytes of memory held by this pool
+         */
+        [[nodiscard]] size_t reserved_bytes() const noexcept {
+            return n_slabs_ * slab_size_;
+        }
+
+        /**
+         * Allocate a single chunk
+         *
+         * @return (non-null) pointer to a chunk of chunk_size() bytes, aligned to at least alignof(void *)
+         * @throws std::bad_alloc on allocation failure
+         */
+        [[nodiscard]] void *allocate() {
+            if (cache_ != nullptr) [[likely]] {
+                void *chunk = cache_;
+                cache_ = next_of(chunk);
+                --n_cached_;
+                ++n_live_;
+                return chunk;
+            }
+
+            if (available_.head == nullptr) [[unlikely]] {
+                refill();
+            }
+
+            slab *s = available_.head;
+
+            void *chunk;
+            if (s->free_list != nullptr) {
+                chunk = s->free_list;
+                s->free_list = next_of(chunk);
+            } else {
+                chunk = s->unused_begin;
+                s->unused_begin += chunk_size_;
+            }
+
+            ++n_live_;
+            if (++s->n_live == chunks_per_slab_) [[unlikely]] {
+                available_.erase(s);
+                full_.push_front(s);
+            }
+            return chunk;
+        }
+
+        /**
+         * Deallocate a chunk previously allocated via allocate()
+         *
+         * @param chunk the chunk. Note: it must have been allocated by `*this`
+         */
+        void deallocate(void *chunk) noexcept {
+            --n_live_;
+            if (n_cached_ < max_cached_chunks_) [[likely]] {
+                set_next_of(chunk, cache_);
+                cache_ = chunk;
+                ++n_cached_;
+            } else {
+                return_to_slab(chunk);
+            }
+
+            if (n_live_ == 0 && n_free_chunks() > trim_threshold_) [[unlikely]] {
+                // cached chunks pin their slabs, do not let them prevent returning memory once all allocations are gone
+                flush_cache();
+                trim();
+            }
+        }
+
+        /**
+         * Return all slabs without live allocations back to the system, e.g. after a peak in memory usage.
+         * Takes O(n) time in the number of slabs with free chunks.
+         *
+         * @return true if any memory was freed
+         */
+        bool release_unused() noexcept {
+            flush_cache();
+
+            bool released = false;
+            for (slab *s = available_.head; s != nullptr;) {
+                slab *next = s->next;
+                if (s->n_live == 0) {
+                    available_.erase(s);
+                    free_slab(s);
+                    released = true;
+                }
+                s = next;
+            }
+            return released;
+        }
+
+        /**
+         * Return all memory back to the system.
+         * This is cheaper than release_unused() but invalidates all allocations of this pool.
+         *
+         * @pre there are no live allocations, or they are never used or deallocated again
+         */
+        void purge_memory() noexcept {
+            for (auto *list : {&available_, &full_}) {
+                for (slab *s = list->head; s != nullptr;) {
+                    slab *next = s->next;
+                    free_slab(s);
+                    s = next;
+                }
+                list->head = nullptr;
+            }
+
+            n_live_ = 0;
+            cache_ = nullptr;
+            n_cached_ = 0;
+        }
+    };
+
+} // namespace dice::template_library
+
+#endif // DICE_TEMPLATELIBRARY_SLABPOOL_HPP
@@ -0,0 +1,121 @@
+#ifndef DICE_TEMPLATELIBRARY_SPINFUTEXMUTEX_HPP
+#define DICE_TEMPLATELIBRARY_SPINFUTEXMUTEX_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+namespace dice::template_library {
+
+    /**
+     * A mutex (satisfying Lockable) for very short critical sections.
+     *
+     * Locking first spins for a bounded time (test-and-test-and-set with exponential backoff), because the lock is likely
+     * released again after a few nanoseconds, and only then blocks the thread via std::atomic::wait (a futex on linux).
+     * Unlocking only makes a syscall if there are blocked threads.
+     * On machines with a single hardware thread, the spinning phase is skipped, because the lock holder cannot make progress while spinning.
+     *
+     * Can be used as the Mutex parameter of dice::template_library::mutex and channel.
+     *
+     * @tparam max_backoff_rounds maximum number of backoff rounds before the thread blocks, the n-th round spins for 2^n pause instructions
+     */
+    template<uint32_t max_backoff_rounds = 7>
+    struct basic_spin_futex_mutex {
+    private:
+        static constexpr uint32_t unlocked = 0;
+        static constexpr uint32_t locked = 1;
+        static constexpr uint32_t locked_contended = 2; ///< locked and there might be threads blocked in state_.wait()
+
+        std::atomic<uint32_t> state_ = unlocked;
+
+        static void pause() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+            asm volatile("yield" ::: "memory");
+#endif
+        }
+
+        static bool is_multiprocessor() noexcept {
+            static bool const res = std::thread::hardware_concurrency() != 1;
+            return res;
+        }
+
+        /**
+         * @return true if the lock was acquired while spinning
+         */
+        bool spin() noexcept {
+            if (!is_multiprocessor()) {
+                return false;
+            }
+
+            for (uint32_t round = 0; round < max_backoff_rounds; ++round) {
+                for (uint32_t ix = 0; ix < (uint32_t{1} << round); ++ix) {
+                    pause();
+                }
+
+                // test before test-and-set, so that spinning threads do not steal the cache line from the lock holder
+                if (state_.load(std::memory_order_relaxed) == unlocked && try_lock()) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        void lock_contended() noexcept {
+            if (spin()) {
+                return;
+            }
+
+            // from now on, the state is locked_contended, so that the unlocking thread knows that it needs to wake someone up
+            while (state_.exchange(locked_contended, std::memory_order_acquire) != unlocked) {
+                state_.wait(locked_contended, std::memory_order_relaxed);
+            }
+        }
+
+    public:
+        basic_spin_futex_mutex() noexcept = default;
+
+        basic_spin_futex_mutex(basic_spin_futex_mutex const &other) = delete;
+        basic_spin_futex_mutex(basic_spin_futex_mutex &&other) = delete;
+        basic_spin_futex_mutex &operator=(basic_spin_futex_mutex const &other) = delete;
+        basic_spin_futex_mutex &operator=(basic_spin_futex_mutex &&other) = delete;
+        ~basic_spin_futex_mutex() = default;
+
+        /**
+         * Lock the mutex, spins for a short time and then blocks until the mutex is available
+         */
+        void lock() noexcept {
+            if (!try_lock()) [[unlikely]] {
+                lock_contended();
+            }
+        }
+
+        /**
+         * Try to lock the mutex without blocking
+         * @return true if the lock was acquired
+         */
+        [[nodiscard]] bool try_lock() noexcept {
+            auto expected = unlocked;
+            return state_.compare_exchange_strong(expected, locked, std::memory_order_acquire, std::memory_order_relaxed);
+        }
+
+        /**
+         * Unlock the mutex, wakes up a blocked thread if there is one
+         */
+        void unlock() noexcept {
+            if (state_.exchange(unlocked, std::memory_order_release) == locked_contended) [[unlikely]] {
+                state_.notify_one();
+            }
+        }
+    };
+
+    /**
+     * basic_spin_futex_mutex with the default spin budget
+     */
+    using spin_futex_mutex = basic_spin_futex_mutex<>;
+
+} // namespace dice::template_library
+
+#endif // DICE_TEMPLATELIBRARY_SPINFUTEXMUTEX_HPP
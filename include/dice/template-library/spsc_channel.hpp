@@ -0,0 +1,290 @@
+#ifndef DICE_TEMPLATELIBRARY_SPSCCHANNEL_HPP
+#define DICE_TEMPLATELIBRARY_SPSCCHANNEL_HPP
+
+#include <dice/template-library/channel.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace dice::template_library {
+
+    /**
+     * A single producer, single consumer channel/queue.
+     *
+     * Backed by a bounded ring buffer with separate, cache-line padded, read and write indices.
+     * Each side caches the last seen index of the other side, so that the cache line of the other side
+     * only needs to be read if the ring buffer looks full (for the producer) or empty (for the consumer).
+     * try_push()/try_pop() are wait-free, push()/pop() only block if the channel is actually full or empty.
+     *
+     * @warning Only one thread may push into the channel and only one thread may pop from it at a time.
+     * @warning close() must be called once the producing thread is done, otherwise the reading thread will hang indefinitely.
+     *          close() must not be called concurrently with a push from the producing thread.
+     *
+     * @tparam T value type of the channel
+     */
+    template<typename T>
+    struct spsc_channel {
+        using value_type = T;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = value_type &;
+        using const_reference = value_type const &;
+        using pointer = T *;
+        using const_pointer = T const *;
+
+    private:
+        struct slot {
+            alignas(T) std::byte storage_[sizeof(T)];
+
+            T *value_ptr() noexcept {
+                return std::launder(reinterpret_cast<T *>(storage_));
+            }
+        };
+
+        size_t n_slots_; ///< capacity + 1, one slot always stays empty to distinguish a full from an empty ring
+        std::unique_ptr<slot[]> ring_; ///< the ring buffer
+
+        alignas(detail_channel::cache_line_size) std::atomic<size_t> write_idx_ = 0; ///< next slot to write to, only modified by the producer
+        size_t cached_read_idx_ = 0; ///< the producer's view of read_idx_
+
+        alignas(detail_channel::cache_line_size) std::atomic<size_t> read_idx_ = 0; ///< next slot to read from, only modified by the consumer
+        size_t cached_write_idx_ = 0; ///< the consumer's view of write_idx_
+
+        // everything below is only touched if a thread needs to block or the channel is closed
+        alignas(detail_channel::cache_line_size) std::atomic_flag closed_ = ATOMIC_FLAG_INIT; ///< true if this channel is closed
+        std::mutex park_mutex_; ///< mutex for queue_not_empty_ and queue_not_full_
+        detail_channel::parking_spot queue_not_empty_; ///< the consumer waits for "there is an element in ring_ or the channel is closed"
+        detail_channel::parking_spot queue_not_full_; ///< the producer waits for "there is a free slot in ring_ or the channel is closed"
+
+        [[nodiscard]] size_t next_idx(size_t idx) const noexcept {
+            return idx + 1 == n_slots_ ? 0 : idx + 1;
+        }
+
+        template<typename ...Args>
+        bool try_emplace_impl(Args &&...args) noexcept(std::is_nothrow_constructible_v<value_type, decltype(std::forward<Args>(args))...>) {
+            auto const write_idx = write_idx_.load(std::memory_order_relaxed);
+            auto const next = next_idx(write_idx);
+
+            if (next == cached_read_idx_) {
+                cached_read_idx_ = read_idx_.load(std::memory_order_acquire);
+                if (next == cached_read_idx_) {
+                    return false;
+                }
+            }
+
+            new (ring_[write_idx].storage_) T(std::forward<Args>(args)...);
+            write_idx_.store(next, std::memory_order_release);
+            return true;
+        }
+
+        std::optional<value_type> try_pop_impl() noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            auto const read_idx = read_idx_.load(std::memory_order_relaxed);
+
+            if (read_idx == cached_write_idx_) {
+                cached_write_idx_ = write_idx_.load(std::memory_order_acquire);
+                if (read_idx == cached_write_idx_) {
+                    return std::nullopt;
+                }
+            }
+
+            auto &s = ring_[read_idx];
+            std::optional<value_type> ret{std::move(*s.value_ptr())};
+            s.value_ptr()->~T();
+            read_idx_.store(next_idx(read_idx), std::memory_order_release);
+            return ret;
+        }
+
+        [[nodiscard]] bool writable_or_closed() const noexcept {
+            return next_idx(write_idx_.load(std::memory_order_relaxed)) != read_idx_.load(std::memory_order_acquire) || closed_.test(std::memory_order_acquire);
+        }
+
+        [[nodiscard]] bool readable_or_closed() const noexcept {
+            return read_idx_.load(std::memory_order_relaxed) != write_idx_.load(std::memory_order_acquire) || closed_.test(std::memory_order_acquire);
+        }
+
+    public:
+        /**
+         * @param capacity number of elements the channel can hold, must be greater than 0
+         * @throws std::invalid_argument if capacity is 0
+         */
+        explicit spsc_channel(size_t capacity) : n_slots_{capacity + 1} {
+            if (capacity == 0) [[unlikely]] {
+                throw std::invalid_argument{"spsc_channel::spsc_channel: capacity must be greater than 0"};
+            }
+            ring_ = std::make_unique<slot[]>(n_slots_);
+        }
+
+        // there is no way to safely implement these with concurrent access
+        spsc_channel(spsc_channel const &other) = delete;
+        spsc_channel(spsc_channel &&other) = delete;
+        spsc_channel &operator=(spsc_channel const &other) = delete;
+        spsc_channel &operator=(spsc_channel &&other) noexcept = delete;
+
+        ~spsc_channel() noexcept {
+            auto const write_idx = write_idx_.load(std::memory_order_relaxed);
+            for (auto idx = read_idx_.load(std::memory_order_relaxed); idx != write_idx; idx = next_idx(idx)) {
+                ring_[idx].value_ptr()->~T();
+            }
+        }
+
+        /**
+         * Close the channel.
+         * After calling close calls to push() will return false
+         * and calls to try_pop will return std::nullopt once the already present elements are exhausted
+         */
+        void close() noexcept {
+            closed_.test_and_set(std::memory_order_seq_cst);
+            queue_not_empty_.unpark_all(park_mutex_); // notify pop() so that it does not get stuck
+            queue_not_full_.unpark_all(park_mutex_); // notify emplace()
+        }
+
+        /**
+         * @return true if this channel is closed
+         */
+        [[nodiscard]] bool closed() const noexcept {
+            return closed_.test(std::memory_order_acquire);
+        }
+
+        /**
+         * Emplace an element into the channel, blocks if there is no capacity left in the channel.
+         *
+         * @param args constructor args
+         * @return true if emplacing the element succeeded because the channel is not yet closed
+         */
+        template<typename ...Args>
+        bool emplace(Args &&...args) noexcept(std::is_nothrow_constructible_v<value_type, decltype(std::forward<Args>(args))...>) {
+            while (true) {
+                if (closed_.test(std::memory_order_relaxed)) [[unlikely]] {
+                    return false;
+                }
+
+                // note: args are only consumed if try_emplace_impl succeeds, so it is fine to forward them in a loop
+                if (try_emplace_impl(std::forward<Args>(args)...)) {
+                    queue_not_empty_.unpark(park_mutex_);
+                    return true;
+                }
+
+                queue_not_full_.park(park_mutex_, [this]() noexcept { return writable_or_closed(); });
+            }
+        }
+
+        /**
+         * Emplace an element into the channel, returns immediately if there is no capacity in the channel.
+         *
+         * @param args constructor args
+         * @return true if emplacing the element succeeded
+         */
+        template<typename ...Args>
+        bool try_emplace(Args &&...args) noexcept(std::is_nothrow_constructible_v<value_type, decltype(std::forward<Args>(args))...>) {
+            if (closed_.test(std::memory_order_relaxed)) [[unlikely]] {
+                return false;
+            }
+
+            if (!try_emplace_impl(std::forward<Args>(args)...)) {
+                return false;
+            }
+
+            queue_not_empty_.unpark(park_mutex_);
+            return true;
+        }
+
+        /**
+         * Push a single element into the channel, blocks if there is no capacity left in the channel.
+         *
+         * @param value the element to push
+         * @return true if pushing the element succeeded because the channel is not yet closed
+         */
+        bool push(value_type const &value) noexcept(std::is_nothrow_copy_constructible_v<value_type>) {
+            return emplace(value);
+        }
+
+        /**
+         * Push a single element into the channel, returns immediately if there is no capacity in the channel.
+         *
+         * @param value the element to push
+         * @return true if pushing the element succeeded because the channel is not yet closed
+         */
+        bool try_push(value_type const &value) noexcept(std::is_nothrow_copy_constructible_v<value_type>) {
+            return try_emplace(value);
+        }
+
+        /**
+         * Push a single element into the channel, blocks if there is no capacity left in the channel.
+         *
+         * @param value the element to push
+         * @return true if pushing the element succeeded because the channel is not yet closed
+         */
+        bool push(value_type &&value) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            return emplace(std::move(value));
+        }
+
+        /**
+         * Push a single element into the channel, returns immediately if there is no capacity in the channel.
+         *
+         * @param value the element to push
+         * @return true if pushing the element succeeded because the channel is not yet closed
+         */
+        bool try_push(value_type &&value) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            return try_emplace(std::move(value));
+        }
+
+        /**
+         * Try to get a (previously pushed) element from the channel.
+         * If there is no element available, blocks until there is one available or the channel is closed.
+         *
+         * @return std::nullopt if the channel was closed, an element otherwise
+         */
+        [[nodiscard]] std::optional<value_type> pop() noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            while (true) {
+                if (auto ret = try_pop(); ret.has_value()) {
+                    return ret;
+                }
+
+                if (closed_.test(std::memory_order_acquire)) [[unlikely]] {
+                    // the producer does not push after closing, but it might have pushed right before closing
+                    return try_pop();
+                }
+
+                queue_not_empty_.park(park_mutex_, [this]() noexcept { return readable_or_closed(); });
+            }
+        }
+
+        /**
+         * Try to get a (previously pushed) element from the channel.
+         * Unlike pop(), if there is no element available, returns std::nullopt immediatly.
+         */
+        [[nodiscard]] std::optional<value_type> try_pop() noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+            auto ret = try_pop_impl();
+            if (ret.has_value()) {
+                queue_not_full_.unpark(park_mutex_);
+            }
+            return ret;
+        }
+
+        using iterator = detail_channel::channel_iterator<spsc_channel>;
+        using sentinel = std::default_sentinel_t;
+
+        /**
+         * @return an iterator over all present and future elements of this channel
+         * @note iterator == end() is true once the channel is closed
+         */
+        [[nodiscard]] iterator begin() noexcept {
+            return iterator{this};
+        }
+
+        [[nodiscard]] sentinel end() const noexcept {
+            return std::default_sentinel;
+        }
+    };
+
+} // namespace dice::template_library
+
+#endif // DICE_TEMPLATELIBRARY_SPSCCHANNEL_HPP
@@ -0,0 +1,171 @@
+#ifndef DICE_TEMPLATELIBRARY_STRIPEDSHAREDMUTEX_HPP
+#define DICE_TEMPLATELIBRARY_STRIPEDSHAREDMUTEX_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace dice::template_library {
+
+    namespace detail_striped_shared_mutex {
+        /**
+         * Size of a cache line, reader counters are padded to this size to avoid false sharing
+         */
+        inline constexpr size_t cache_line_size = 64;
+
+        /**
+         * @return a per-thread value used to pick the reader counter of the calling thread,
+         *         threads are assigned round-robin so that up to n_stripes threads never share a counter
+         */
+        inline size_t thread_stripe_hint() noexcept {
+            static std::atomic<size_t> next_hint = 0;
+            static thread_local size_t const hint = next_hint.fetch_add(1, std::memory_order_relaxed);
+            return hint;
+        }
+    } // namespace detail_striped_shared_mutex
+
+    /**
+     * A reader-writer mutex (satisfying SharedMutex) for read-mostly workloads with many concurrent readers.
+     *
+     * Instead of a single reader counter (like std::shared_mutex), whose cache line is modified by every reader,
+     * readers are counted in n_stripes separate cache-line padded counters and each thread only touches its own one.
+     * Acquiring a shared lock therefore does not contend with other readers as long as there are at most n_stripes reading threads.
+     * A writer announces itself via a flag, which makes new readers back off, and then waits until all counters are zero,
+     * i.e. writers are preferred over new readers and locking exclusively is more expensive than with std::shared_mutex.
+     *
+     * Can be used as the Mutex parameter of dice::template_library::shared_mutex.
+     *
+     * @warning unlock_shared() must be called by the same thread that called lock_shared()
+     *
+     * @tparam n_stripes number of reader counters
+     */
+    template<size_t n_stripes = 64>
+    struct striped_shared_mutex {
+        static_assert(n_stripes > 0);
+
+    private:
+        struct alignas(detail_striped_shared_mutex::cache_line_size) stripe {
+            std::atomic<uint32_t> n_readers = 0;
+        };
+
+        std::array<stripe, n_stripes> stripes_; ///< reader counters
+        alignas(detail_striped_shared_mutex::cache_line_size) std::atomic<bool> writer_active_ = false; ///< true while a writer holds or is acquiring the lock
+        std::mutex writer_mutex_; ///< serializes writers
+
+        [[nodiscard]] static std::atomic<uint32_t> &own_counter(std::array<stripe, n_stripes> &stripes) noexcept {
+            return stripes[detail_striped_shared_mutex::thread_stripe_hint() % n_stripes].n_readers;
+        }
+
+        /**
+         * Try to register the calling thread as a reader.
+         * @return true if the shared lock was acquired, false if a writer is active
+         */
+        [[nodiscard]] bool try_enter_shared(std::atomic<uint32_t> &counter) noexcept {
+            // seq_cst pairs with lock(): either the writer sees this counter or this reader sees writer_active_
+            counter.fetch_add(1, std::memory_order_seq_cst);
+            if (!writer_active_.load(std::memory_order_seq_cst)) [[likely]] {
+                return true;
+            }
+
+            counter.fetch_sub(1, std::memory_order_release);
+            return false;
+        }
+
+        /**
+         * @return true if there are no readers
+         */
+        [[nodiscard]] bool no_readers() const noexcept {
+            for (auto const &s : stripes_) {
+                if (s.n_readers.load(std::memory_order_seq_cst) != 0) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        void release_writer() noexcept {
+            writer_active_.store(false, std::memory_order_release);
+            writer_active_.notify_all();
+        }
+
+    public:
+        striped_shared_mutex() noexcept = default;
+
+        striped_shared_mutex(striped_shared_mutex const &other) = delete;
+        striped_shared_mutex(striped_shared_mutex &&other) = delete;
+        striped_shared_mutex &operator=(striped_shared_mutex const &other) = delete;
+        striped_shared_mutex &operator=(striped_shared_mutex &&other) = delete;
+        ~striped_shared_mutex() = default;
+
+        /**
+         * Lock the mutex exclusively, blocks until all readers have left
+         */
+        void lock() {
+            writer_mutex_.lock();
+            writer_active_.store(true, std::memory_order_seq_cst);
+
+            // readers only hold the lock briefly, so yielding is cheaper than having every reader notify the writer
+            while (!no_readers()) {
+                std::this_thread::yield();
+            }
+        }
+
+        /**
+         * Try to lock the mutex exclusively without blocking
+         * @return true if the lock was acquired
+         */
+        [[nodiscard]] bool try_lock() {
+            if (!writer_mutex_.try_lock()) {
+                return false;
+            }
+
+            writer_active_.store(true, std::memory_order_seq_cst);
+            if (no_readers()) {
+                return true;
+            }
+
+            release_writer();
+            writer_mutex_.unlock();
+            return false;
+        }
+
+        /**
+         * Unlock the exclusively locked mutex
+         */
+        void unlock() noexcept {
+            release_writer();
+            writer_mutex_.unlock();
+        }
+
+        /**
+         * Lock the mutex for shared ownership, blocks while a writer holds or is acquiring the lock
+         */
+        void lock_shared() noexcept {
+            auto &counter = own_counter(stripes_);
+            while (!try_enter_shared(counter)) {
+                writer_active_.wait(true, std::memory_order_acquire);
+            }
+        }
+
+        /**
+         * Try to lock the mutex for shared ownership without blocking
+         * @return true if the lock was acquired
+         */
+        [[nodiscard]] bool try_lock_shared() noexcept {
+            return try_enter_shared(own_counter(stripes_));
+        }
+
+        /**
+         * Unlock the mutex from shared ownership
+         */
+        void unlock_shared() noexcept {
+            own_counter(stripes_).fetch_sub(1, std::memory_order_release);
+        }
+    };
+
+} // namespace dice::template_library
+
+#endif // DICE_TEMPLATELIBRARY_STRIPEDSHAREDMUTEX_HPP
@@ -0,0 +1,152 @@
+#ifndef DICE_TEMPLATELIBRARY_TRIPLEBUFFER_HPP
+#define DICE_TEMPLATELIBRARY_TRIPLEBUFFER_HPP
+
+#include <dice/template-library/channel.hpp>
+
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+namespace dice::template_library {
+
+    /**
+     * A single producer, single consumer "latest value wins" exchange of (potentially large) values,
+     * like exchange_channel, but without locking and without constructing or copying a value per exchange.
+     *
+     * The value is triple buffered: the producer writes into its back buffer in place and publishes it
+     * by atomically swapping it with the middle buffer. The consumer picks up the latest published buffer by atomically
+     * swapping its front buffer with the middle buffer and then reads the front buffer in place.
+     * Neither side ever waits for the other, and a buffer is never accessed by both sides at the same time.
+     *
+     * The buffers are reused, i.e. after publish() the back buffer contains an older value (not necessarily the previous one)
+     * that the producer needs to overwrite (or update) in place. This allows the producer to reuse the allocations of T.
+     *
+     * @warning Only one thread may produce (back(), publish(), push(), write()) and only one thread may consume (update(), front(), read()) at a time.
+     *
+     * @tparam T value type of the buffers
+     */
+    template<typename T>
+    struct triple_buffer {
+        using value_type = T;
+        using reference = value_type &;
+        using const_reference = value_type const &;
+
+    private:
+        static constexpr uint8_t index_mask = 0b011;
+        static constexpr uint8_t fresh_bit = 0b100; ///< set in middle_ if the middle buffer was published but not yet picked up by the consumer
+
+        struct alignas(detail_channel::cache_line_size) buffer {
+            T value_;
+        };
+
+        std::array<buffer, 3> buffers_;
+
+        alignas(detail_channel::cache_line_size) uint8_t back_ = 0; ///< index of the buffer the producer writes to, only accessed by the producer
+        alignas(detail_channel::cache_line_size) std::atomic<uint8_t> middle_ = 1; ///< index of the buffer that is exchanged, combined with fresh_bit
+        alignas(detail_channel::cache_line_size) uint8_t front_ = 2; ///< index of the buffer the consumer reads from, only accessed by the consumer
+
+    public:
+        /**
+         * Construct a triple_buffer with three default constructed buffers
+         */
+        triple_buffer() noexcept(std::is_nothrow_default_constructible_v<T>) requires (std::default_initializable<T>) = default;
+
+        /**
+         * Construct a triple_buffer with all three buffers initialized to a copy of initial
+         * @param initial initial value of the buffers
+         */
+        explicit triple_buffer(T const &initial) noexcept(std::is_nothrow_copy_constructible_v<T>) requires (std::copy_constructible<T>)
+            : buffers_{buffer{initial}, buffer{initial}, buffer{initial}} {
+        }
+
+        triple_buffer(triple_buffer const &other) = delete;
+        triple_buffer(triple_buffer &&other) = delete;
+        triple_buffer &operator=(triple_buffer const &other) = delete;
+        triple_buffer &operator=(triple_buffer &&other) noexcept = delete;
+        ~triple_buffer() = default;
+
+        /**
+         * Producer: access the back buffer to write the next value in place.
+         * @return reference to the back buffer, invalidated by publish()
+         */
+        [[nodiscard]] reference back() noexcept {
+            return buffers_[back_].value_;
+        }
+
+        /**
+         * Producer: publish the back buffer, making it the latest value.
+         * If the previously published value was not picked up by the consumer, it is discarded.
+         * Afterward, back() refers to a different buffer.
+         */
+        void publish() noexcept {
+            back_ = middle_.exchange(back_ | fresh_bit, std::memory_order_acq_rel) & index_mask;
+        }
+
+        /**
+         * Producer: invoke func on the back buffer and publish it afterward.
+         * @param func callable that updates the back buffer in place
+         */
+        template<typename F> requires (std::invocable<F, reference>)
+        void write(F &&func) noexcept(std::is_nothrow_invocable_v<F, reference>) {
+            std::invoke(std::forward<F>(func), back());
+            publish();
+        }
+
+        /**
+         * Producer: assign value to the back buffer and publish it.
+         * Uses assignment instead of construction, so allocations of the back buffer can be reused.
+         * @param value new value
+         */
+        template<typename U> requires (std::assignable_from<reference, U>)
+        void push(U &&value) noexcept(std::is_nothrow_assignable_v<reference, U>) {
+            back() = std::forward<U>(value);
+            publish();
+        }
+
+        /**
+         * Consumer: check if a value was published that was not picked up by update() yet
+         */
+        [[nodiscard]] bool has_update() const noexcept {
+            return (middle_.load(std::memory_order_relaxed) & fresh_bit) != 0;
+        }
+
+        /**
+         * Consumer: make the latest published value the front buffer, if there is a new one.
+         * @return true if the front buffer changed
+         */
+        bool update() noexcept {
+            if (!has_update()) {
+                return false;
+            }
+
+            front_ = middle_.exchange(front_, std::memory_order_acq_rel) & index_mask;
+            return true;
+        }
+
+        /**
+         * Consumer: access the front buffer, i.e. the value picked up by the last call to update()
+         * (or the initial value if there was none).
+         * @return reference to the front buffer, invalidated by update()
+         */
+        [[nodiscard]] reference front() noexcept {
+            return buffers_[front_].value_;
+        }
+
+        /**
+         * Consumer: pick up the latest published value (if there is a new one) and access it.
+         * @return reference to the front buffer, invalidated by the next update()
+         */
+        [[nodiscard]] reference read() noexcept {
+            update();
+            return front();
+        }
+    };
+
+} // namespace dice::template_library
+
+#endif // DICE_TEMPLATELIBRARY_TRIPLEBUFFER_HPP
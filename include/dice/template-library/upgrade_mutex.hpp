@@ -0,0 +1,209 @@
+#ifndef DICE_TEMPLATELIBRARY_UPGRADEMUTEX_HPP
+#define DICE_TEMPLATELIBRARY_UPGRADEMUTEX_HPP
+
+#include <concepts>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace dice::template_library {
+
+    /**
+     * A shared mutex that additionally supports upgradable ownership, which can be converted to exclusive ownership atomically.
+     */
+    template<typename Mutex>
+    concept upgrade_lockable = requires (Mutex &mut) {
+        mut.lock_upgrade();
+        { mut.try_lock_upgrade() } -> std::same_as<bool>;
+        mut.unlock_upgrade();
+        mut.unlock_upgrade_and_lock();
+    };
+
+    /**
+     * A shared mutex whose exclusive ownership can be atomically converted to shared ownership.
+     */
+    template<typename Mutex>
+    concept downgrade_lockable = requires (Mutex &mut) {
+        mut.unlock_and_lock_shared();
+    };
+
+    /**
+     * A reader-writer mutex (satisfying SharedMutex) that additionally supports upgradable ownership (like boost::upgrade_mutex).
+     *
+     * Upgradable ownership coexists with shared ownership, but at most one thread can have upgradable ownership at a time.
+     * It can be converted to exclusive ownership atomically (unlock_upgrade_and_lock()), i.e. without giving other writers a chance
+     * to modify the protected state in between. Exclusive ownership can also be atomically converted back to shared or upgradable ownership.
+     *
+     * Writers are preferred: once a writer (or upgrading thread) waits for the readers to leave, no new readers are admitted.
+     *
+     * Can be used as the Mutex parameter of dice::template_library::shared_mutex, which then provides lock_upgradable() and downgrade().
+     */
+    struct upgrade_mutex {
+    private:
+        static constexpr uint32_t write_entered = uint32_t{1} << 31; ///< a writer owns or is acquiring the lock
+        static constexpr uint32_t upgradable_entered = uint32_t{1} << 30; ///< a thread has upgradable ownership
+        static constexpr uint32_t n_readers_mask = ~(write_entered | upgradable_entered); ///< number of threads with shared or upgradable ownership
+
+        std::mutex mutex_; ///< mutex for state_
+        std::condition_variable gate1_; ///< threads waiting to enter (as reader, upgrader or writer)
+        std::condition_variable gate2_; ///< the writer waiting for the readers to leave
+        uint32_t state_ = 0;
+
+        [[nodiscard]] uint32_t n_readers() const noexcept {
+            return state_ & n_readers_mask;
+        }
+
+        [[nodiscard]] bool can_enter_shared() const noexcept {
+            return (state_ & write_entered) == 0 && n_readers() != n_readers_mask;
+        }
+
+        [[nodiscard]] bool can_enter_upgrade() const noexcept {
+            return (state_ & (write_entered | upgradable_entered)) == 0 && n_readers() != n_readers_mask;
+        }
+
+    public:
+        upgrade_mutex() = default;
+
+        upgrade_mutex(upgrade_mutex const &other) = delete;
+        upgrade_mutex(upgrade_mutex &&other) = delete;
+        upgrade_mutex &operator=(upgrade_mutex const &other) = delete;
+        upgrade_mutex &operator=(upgrade_mutex &&other) = delete;
+        ~upgrade_mutex() = default;
+
+        /**
+         * Lock the mutex exclusively
+         */
+        void lock() {
+            std::unique_lock lock{mutex_};
+            gate1_.wait(lock, [this]() noexcept { return (state_ & (write_entered | upgradable_entered)) == 0; });
+            state_ |= write_entered;
+            gate2_.wait(lock, [this]() noexcept { return n_readers() == 0; });
+        }
+
+        /**
+         * Try to lock the mutex exclusively without blocking
+         * @return true if the lock was acquired
+         */
+        [[nodiscard]] bool try_lock() {
+            std::lock_guard lock{mutex_};
+            if (state_ != 0) {
+                return false;
+            }
+
+            state_ = write_entered;
+            return true;
+        }
+
+        void unlock() {
+            {
+                std::lock_guard lock{mutex_};
+                state_ = 0;
+            }
+            gate1_.notify_all();
+        }
+
+        /**
+         * Lock the mutex for shared ownership
+         */
+        void lock_shared() {
+            std::unique_lock lock{mutex_};
+            gate1_.wait(lock, [this]() noexcept { return can_enter_shared(); });
+            ++state_;
+        }
+
+        /**
+         * Try to lock the mutex for shared ownership without blocking
+         * @return true if the lock was acquired
+         */
+        [[nodiscard]] bool try_lock_shared() {
+            std::lock_guard lock{mutex_};
+            if (!can_enter_shared()) {
+                return false;
+            }
+
+            ++state_;
+            return true;
+        }
+
+        void unlock_shared() {
+            std::lock_guard lock{mutex_};
+            --state_;
+            if (state_ & write_entered) {
+                if (n_readers() == 0) {
+                    gate2_.notify_one();
+                }
+            } else if (n_readers() == n_readers_mask - 1) {
+                gate1_.notify_one();
+            }
+        }
+
+        /**
+         * Lock the mutex for upgradable ownership, coexists with shared ownership of other threads
+         */
+        void lock_upgrade() {
+            std::unique_lock lock{mutex_};
+            gate1_.wait(lock, [this]() noexcept { return can_enter_upgrade(); });
+            state_ |= upgradable_entered;
+            ++state_;
+        }
+
+        /**
+         * Try to lock the mutex for upgradable ownership without blocking
+         * @return true if the lock was acquired
+         */
+        [[nodiscard]] bool try_lock_upgrade() {
+            std::lock_guard lock{mutex_};
+            if (!can_enter_upgrade()) {
+                return false;
+            }
+
+            state_ |= upgradable_entered;
+            ++state_;
+            return true;
+        }
+
+        void unlock_upgrade() {
+            {
+                std::lock_guard lock{mutex_};
+                state_ &= ~upgradable_entered;
+                --state_;
+            }
+            gate1_.notify_all();
+        }
+
+        /**
+         * Atomically convert upgradable ownership into exclusive ownership, blocks until all readers have left
+         */
+        void unlock_upgrade_and_lock() {
+            std::unique_lock lock{mutex_};
+            state_ = (state_ & ~upgradable_entered) - 1;
+            state_ |= write_entered;
+            gate2_.wait(lock, [this]() noexcept { return n_readers() == 0; });
+        }
+
+        /**
+         * Atomically convert exclusive ownership into shared ownership
+         */
+        void unlock_and_lock_shared() {
+            {
+                std::lock_guard lock{mutex_};
+                state_ = 1;
+            }
+            gate1_.notify_all();
+        }
+
+        /**
+         * Atomically convert exclusive ownership into upgradable ownership
+         */
+        void unlock_and_lock_upgrade() {
+            {
+                std::lock_guard lock{mutex_};
+                state_ = upgradable_entered | 1;
+            }
+            gate1_.notify_all();
+        }
+    };
+
+} // namespace dice::template_library
+
+#endif // DICE_TEMPLATELIBRARY_UPGRADEMUTEX_HPP
@@ -0,0 +1,617 @@
+#ifndef DICE_TEMPLATELIBRARY_VECDEQUE_HPP
+#define DICE_TEMPLATELIBRARY_VECDEQUE_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace dice::template_library {
+
+    /**
+     * A double-ended queue implemented as a growable ring buffer (like rust's VecDeque https://doc.rust-lang.org/std/collections/struct.VecDeque.html).
+     *
+     * Unlike std::deque, all elements live in a single allocation, which means that
+     * the capacity can be reserved up front with reserve() and is never given back unless shrink_to_fit() is called.
+     * Therefore, a vec_deque that is used as a FIFO queue does not allocate once it reached its steady-state size.
+     * The (at most two) contiguous regions that make up the elements are available via as_slices().
+     *
+     * @tparam T element type
+     * @tparam Allocator allocator for T
+     */
+    template<typename T, typename Allocator = std::allocator<T>>
+    struct vec_deque {
+        using value_type = T;
+        using allocator_type = Allocator;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = value_type &;
+        using const_reference = value_type const &;
+        using pointer = typename std::allocator_traits<allocator_type>::pointer;
+        using const_pointer = typename std::allocator_traits<allocator_type>::const_pointer;
+
+    private:
+        using alloc_traits = std::allocator_traits<allocator_type>;
+
+        template<bool is_const>
+        struct iterator_impl {
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using reference = std::conditional_t<is_const, T const &, T &>;
+            using pointer = std::conditional_t<is_const, T const *, T *>;
+            using iterator_category = std::random_access_iterator_tag;
+            using iterator_concept = std::random_access_iterator_tag;
+
+        private:
+            friend struct vec_deque;
+
+            using container_type = std::conditional_t<is_const, vec_deque const, vec_deque>;
+
+            container_type *container_ = nullptr;
+            size_type ix_ = 0; ///< logical index into container_
+
+            iterator_impl(container_type *container, size_type ix) noexcept : container_{container}, ix_{ix} {
+            }
+
+        public:
+            iterator_impl() noexcept = default;
+
+            iterator_impl(iterator_impl<!is_const> const &other) noexcept requires (is_const)
+                : container_{other.container_}, ix_{other.ix_} {
+            }
+
+            reference operator*() const noexcept {
+                return (*container_)[ix_];
+            }
+
+            pointer operator->() const noexcept {
+                return &(*container_)[ix_];
+            }
+
+            reference operator[](difference_type n) const noexcept {
+                return (*container_)[ix_ + n];
+            }
+
+            iterator_impl &operator++() noexcept {
+                ++ix_;
+                return *this;
+            }
+
+            iterator_impl operator++(int) noexcept {
+                auto cpy = *this;
+                ++ix_;
+                return cpy;
+            }
+
+            iterator_impl &operator--() noexcept {
+                --ix_;
+                return *this;
+            }
+
+            iterator_impl operator--(int) noexcept {
+                auto cpy = *this;
+                --ix_;
+                return cpy;
+            }
+
+            iterator_impl &operator+=(difference_type n) noexcept {
+                ix_ += n;
+                return *this;
+            }
+
+            iterator_impl &operator-=(difference_type n) noexcept {
+                ix_ -= n;
+                return *this;
+            }
+
+            friend iterator_impl operator+(iterator_impl it, difference_type n) noexcept {
+                it += n;
+                return it;
+            }
+
+            friend iterator_impl operator+(difference_type n, iterator_impl it) noexcept {
+                it += n;
+                return it;
+            }
+
+            friend iterator_impl operator-(iterator_impl it, difference_type n) noexcept {
+                it -= n;
+                return it;
+            }
+
+            friend difference_type operator-(iterator_impl const &lhs, iterator_impl const &rhs) noexcept {
+                return static_cast<difference_type>(lhs.ix_) - static_cast<difference_type>(rhs.ix_);
+            }
+
+            friend bool operator==(iterator_impl const &lhs, iterator_impl const &rhs) noexcept {
+                assert(lhs.container_ == rhs.container_);
+                return lhs.ix_ == rhs.ix_;
+            }
+
+            friend std::strong_ordering operator<=>(iterator_impl const &lhs, iterator_impl const &rhs) noexcept {
+                assert(lhs.container_ == rhs.container_);
+                return lhs.ix_ <=> rhs.ix_;
+            }
+        };
+
+    public:
+        using iterator = iterator_impl<false>;
+        using const_iterator = iterator_impl<true>;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    private:
+        pointer data_ = nullptr;
+        size_type cap_ = 0;
+        size_type head_ = 0; ///< physical index of the first element
+        size_type size_ = 0;
+        [[no_unique_address]] allocator_type alloc_;
+
+        /**
+         * @return physical index of the logical index ix
+         */
+        [[nodiscard]] size_type physical_index(size_type ix) const noexcept {
+            // equivalent to (head_ + ix) % cap_, but without the division
+            return ix >= cap_ - head_ ? ix - (cap_ - head_) : head_ + ix;
+        }
+
+        [[nodiscard]] T *slot(size_type physical_ix) const noexcept {
+            return std::to_address(data_) + physical_ix;
+        }
+
+        /**
+         * Moves all elements into a new allocation of exactly new_cap elements.
+         * If moving an element throws, the state of *this is unchanged.
+         */
+        void reallocate(size_type new_cap) {
+            assert(new_cap >= size_);
+
+            pointer new_data = new_cap > 0 ? alloc_traits::allocate(alloc_, new_cap) : nullptr;
+
+            size_type n_constructed = 0;
+            try {
+                for (; n_constructed < size_; ++n_constructed) {
+                    alloc_traits::construct(alloc_, std::to_address(new_data) + n_constructed, std::move_if_noexcept((*this)[n_constructed]));
+                }
+            } catch (...) {
+                for (size_type ix = 0; ix < n_constructed; ++ix) {
+                    alloc_traits::destroy(alloc_, std::to_address(new_data) + ix);
+                }
+                alloc_traits::deallocate(alloc_, new_data, new_cap);
+                throw;
+            }
+
+            destroy_elements();
+            if (data_ != nullptr) {
+                alloc_traits::deallocate(alloc_, data_, cap_);
+            }
+
+            data_ = new_data;
+            cap_ = new_cap;
+            head_ = 0;
+        }
+
+        [[nodiscard]] size_type grown_capacity() const noexcept {
+            return std::max(size_type{4}, 2 * cap_);
+        }
+
+        /**
+         * Constructs a new element at physical index phys_ix(), growing the buffer if necessary.
+         * If growing is necessary, the element is constructed before reallocating
+         * because args might refer to elements of *this.
+         */
+        template<typename PhysIx, typename ...Args>
+        T *construct_with_growth(PhysIx phys_ix, Args &&...args) {
+            if (size_ == cap_) [[unlikely]] {
+                value_type tmp(std::forward<Args>(args)...);
+                reallocate(grown_capacity());
+
+                auto *elem = slot(phys_ix());
+                alloc_traits::construct(alloc_, elem, std::move(tmp));
+                return elem;
+            }
+
+            auto *elem = slot(phys_ix());
+            alloc_traits::construct(alloc_, elem, std::forward<Args>(args)...);
+            return elem;
+        }
+
+        void destroy_elements() noexcept {
+            for (size_type ix = 0; ix < size_; ++ix) {
+                alloc_traits::destroy(alloc_, slot(physical_index(ix)));
+            }
+        }
+
+        void release_storage() noexcept {
+            destroy_elements();
+            if (data_ != nullptr) {
+                alloc_traits::deallocate(alloc_, data_, cap_);
+            }
+
+            data_ = nullptr;
+            cap_ = 0;
+            head_ = 0;
+            size_ = 0;
+        }
+
+        void steal_storage(vec_deque &other) noexcept {
+            data_ = std::exchange(other.data_, nullptr);
+            cap_ = std::exchange(other.cap_, 0);
+            head_ = std::exchange(other.head_, 0);
+            size_ = std::exchange(other.size_, 0);
+        }
+
+        template<typename Iter, typename Sent>
+        void append(Iter first, Sent last) {
+            for (; first != last; ++first) {
+                emplace_back(*first);
+            }
+        }
+
+    public:
+        vec_deque() noexcept(std::is_nothrow_default_constructible_v<allocator_type>) = default;
+
+        explicit vec_deque(allocator_type const &alloc) noexcept : alloc_{alloc} {
+        }
+
+        explicit vec_deque(size_type n, allocator_type const &alloc = allocator_type{}) : alloc_{alloc} {
+            reserve(n);
+            for (size_type ix = 0; ix < n; ++ix) {
+                emplace_back();
+            }
+        }
+
+        vec_deque(size_type n, value_type const &value, allocator_type const &alloc = allocator_type{}) : alloc_{alloc} {
+            reserve(n);
+            for (size_type ix = 0; ix < n; ++ix) {
+                emplace_back(value);
+            }
+        }
+
+        template<std::input_iterator Iter, std::sentinel_for<Iter> Sent>
+        vec_deque(Iter first, Sent last, allocator_type const &alloc = allocator_type{}) : alloc_{alloc} {
+            if constexpr (std::sized_sentinel_for<Sent, Iter>) {
+                reserve(static_cast<size_type>(std::distance(first, last)));
+            }
+            append(first, last);
+        }
+
+        vec_deque(std::initializer_list<value_type> init, allocator_type const &alloc = allocator_type{})
+            : vec_deque{init.begin(), init.end(), alloc} {
+        }
+
+        vec_deque(vec_deque const &other)
+            : vec_deque{other.begin(), other.end(), alloc_traits::select_on_container_copy_construction(other.alloc_)} {
+        }
+
+        vec_deque(vec_deque const &other, allocator_type const &alloc)
+            : vec_deque{other.begin(), other.end(), alloc} {
+        }
+
+        vec_deque(vec_deque &&other) noexcept : alloc_{std::move(other.alloc_)} {
+            steal_storage(other);
+        }
+
+        vec_deque(vec_deque &&other, allocator_type const &alloc) : alloc_{alloc} {
+            if (alloc_ == other.alloc_) {
+                steal_storage(other);
+            } else {
+                reserve(other.size());
+                for (auto &elem : other) {
+                    emplace_back(std::move(elem));
+                }
+            }
+        }
+
+        vec_deque &operator=(vec_deque const &other) {
+            if (this == &other) {
+                return *this;
+            }
+
+            if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+                if (alloc_ != other.alloc_) {
+                    release_storage();
+                }
+                alloc_ = other.alloc_;
+            }
+
+            clear();
+            reserve(other.size());
+            append(other.begin(), other.end());
+            return *this;
+        }
+
+        vec_deque &operator=(vec_deque &&other) noexcept(alloc_traits::propagate_on_container_move_assignment::value
+                                                          || alloc_traits::is_always_equal::value) {
+            assert(this != &other);
+
+            if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+                release_storage();
+                alloc_ = std::move(other.alloc_);
+                steal_storage(other);
+            } else {
+                if (alloc_ == other.alloc_) {
+                    release_storage();
+                    steal_storage(other);
+                } else {
+                    // not allowed to propagate, need to move element-wise
+                    clear();
+                    reserve(other.size());
+                    for (auto &elem : other) {
+                        emplace_back(std::move(elem));
+                    }
+                }
+            }
+
+            return *this;
+        }
+
+        vec_deque &operator=(std::initializer_list<value_type> init) {
+            clear();
+            reserve(init.size());
+            append(init.begin(), init.end());
+            return *this;
+        }
+
+        ~vec_deque() {
+            release_storage();
+        }
+
+        [[nodiscard]] allocator_type get_allocator() const noexcept {
+            return alloc_;
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return size_ == 0;
+        }
+
+        [[nodiscard]] size_type size() const noexcept {
+            return size_;
+        }
+
+        [[nodiscard]] size_type max_size() const noexcept {
+            return alloc_traits::max_size(alloc_);
+        }
+
+        /**
+         * @return number of elements that can be held without allocating
+         */
+        [[nodiscard]] size_type capacity() const noexcept {
+            return cap_;
+        }
+
+        /**
+         * Makes sure that at least new_cap elements can be held without allocating.
+         * Does not allocate if new_cap <= capacity().
+         */
+        void reserve(size_type new_cap) {
+            if (new_cap <= cap_) {
+                return;
+            }
+
+            if (new_cap > max_size()) [[unlikely]] {
+                throw std::length_error{"vec_deque::reserve: new_cap exceeds max_size()"};
+            }
+
+            reallocate(new_cap);
+        }
+
+        /**
+         * Reduces capacity() to size()
+         */
+        void shrink_to_fit() {
+            if (cap_ > size_) {
+                reallocate(size_);
+            }
+        }
+
+        [[nodiscard]] reference operator[](size_type ix) noexcept {
+            assert(ix < size_);
+            return *slot(physical_index(ix));
+        }
+
+        [[nodiscard]] const_reference operator[](size_type ix) const noexcept {
+            assert(ix < size_);
+            return *slot(physical_index(ix));
+        }
+
+        [[nodiscard]] reference at(size_type ix) {
+            if (ix >= size_) [[unlikely]] {
+                throw std::out_of_range{"vec_deque::at: index out of range"};
+            }
+            return (*this)[ix];
+        }
+
+        [[nodiscard]] const_reference at(size_type ix) const {
+            if (ix >= size_) [[unlikely]] {
+                throw std::out_of_range{"vec_deque::at: index out of range"};
+            }
+            return (*this)[ix];
+        }
+
+        [[nodiscard]] reference front() noexcept {
+            assert(!empty());
+            return *slot(head_);
+        }
+
+        [[nodiscard]] const_reference front() const noexcept {
+            assert(!empty());
+            return *slot(head_);
+        }
+
+        [[nodiscard]] reference back() noexcept {
+            assert(!empty());
+            return (*this)[size_ - 1];
+        }
+
+        [[nodiscard]] const_reference back() const noexcept {
+            assert(!empty());
+            return (*this)[size_ - 1];
+        }
+
+        /**
+         * @return the elements in order, as (at most) two contiguous regions.
+         *         The second span is empty if the elements do not wrap around the end of the buffer.
+         */
+        [[nodiscard]] std::pair<std::span<value_type>, std::span<value_type>> as_slices() noexcept {
+            auto const first_len = std::min(size_, cap_ - head_);
+            return {std::span<value_type>{slot(head_), first_len}, std::span<value_type>{slot(0), size_ - first_len}};
+        }
+
+        [[nodiscard]] std::pair<std::span<value_type const>, std::span<value_type const>> as_slices() const noexcept {
+            auto const first_len = std::min(size_, cap_ - head_);
+            return {std::span<value_type const>{slot(head_), first_len}, std::span<value_type const>{slot(0), size_ - first_len}};
+        }
+
+        template<typename ...Args>
+        reference emplace_back(Args &&...args) {
+            auto *elem = construct_with_growth([this]() noexcept { return physical_index(size_); }, std::forward<Args>(args)...);
+            ++size_;
+            return *elem;
+        }
+
+        template<typename ...Args>
+        reference emplace_front(Args &&...args) {
+            auto *elem = construct_with_growth([this]() noexcept { return head_ == 0 ? cap_ - 1 : head_ - 1; }, std::forward<Args>(args)...);
+            head_ = head_ == 0 ? cap_ - 1 : head_ - 1;
+            ++size_;
+            return *elem;
+        }
+
+        void push_back(value_type const &value) {
+            emplace_back(value);
+        }
+
+        void push_back(value_type &&value) {
+            emplace_back(std::move(value));
+        }
+
+        void push_front(value_type const &value) {
+            emplace_front(value);
+        }
+
+        void push_front(value_type &&value) {
+            emplace_front(std::move(value));
+        }
+
+        void pop_back() noexcept {
+            assert(!empty());
+            alloc_traits::destroy(alloc_, slot(physical_index(size_ - 1)));
+            --size_;
+        }
+
+        void pop_front() noexcept {
+            assert(!empty());
+            alloc_traits::destroy(alloc_, slot(head_));
+            head_ = head_ + 1 == cap_ ? 0 : head_ + 1;
+            --size_;
+        }
+
+        /**
+         * Resizes to n elements. New elements are value-initialized.
+         */
+        void resize(size_type n) {
+            if (n < size_) {
+                while (size_ > n) {
+                    pop_back();
+                }
+                return;
+            }
+
+            reserve(n);
+            while (size_ < n) {
+                emplace_back();
+            }
+        }
+
+        /**
+         * Removes all elements, keeps the capacity
+         */
+        void clear() noexcept {
+            destroy_elements();
+            head_ = 0;
+            size_ = 0;
+        }
+
+        [[nodiscard]] iterator begin() noexcept {
+            return iterator{this, 0};
+        }
+
+        [[nodiscard]] iterator end() noexcept {
+            return iterator{this, size_};
+        }
+
+        [[nodiscard]] const_iterator begin() const noexcept {
+            return const_iterator{this, 0};
+        }
+
+        [[nodiscard]] const_iterator end() const noexcept {
+            return const_iterator{this, size_};
+        }
+
+        [[nodiscard]] const_iterator cbegin() const noexcept {
+            return begin();
+        }
+
+        [[nodiscard]] const_iterator cend() const noexcept {
+            return end();
+        }
+
+        [[nodiscard]] reverse_iterator rbegin() noexcept {
+            return reverse_iterator{end()};
+        }
+
+        [[nodiscard]] reverse_iterator rend() noexcept {
+            return reverse_iterator{begin()};
+        }
+
+        [[nodiscard]] const_reverse_iterator rbegin() const noexcept {
+            return const_reverse_iterator{end()};
+        }
+
+        [[nodiscard]] const_reverse_iterator rend() const noexcept {
+            return const_reverse_iterator{begin()};
+        }
+
+        [[nodiscard]] const_reverse_iterator crbegin() const noexcept {
+            return rbegin();
+        }
+
+        [[nodiscard]] const_reverse_iterator crend() const noexcept {
+            return rend();
+        }
+
+        friend void swap(vec_deque &lhs, vec_deque &rhs) noexcept {
+            using std::swap;
+
+            if constexpr (alloc_traits::propagate_on_container_swap::value) {
+                swap(lhs.alloc_, rhs.alloc_);
+            } else {
+                assert(lhs.alloc_ == rhs.alloc_);
+            }
+
+            swap(lhs.data_, rhs.data_);
+            swap(lhs.cap_, rhs.cap_);
+            swap(lhs.head_, rhs.head_);
+            swap(lhs.size_, rhs.size_);
+        }
+
+        friend bool operator==(vec_deque const &lhs, vec_deque const &rhs) noexcept(noexcept(std::declval<T const &>() == std::declval<T const &>())) {
+            return std::ranges::equal(lhs, rhs);
+        }
+
+        friend auto operator<=>(vec_deque const &lhs, vec_deque const &rhs) requires std::three_way_comparable<T> {
+            return std::lexicographical_compare_three_way(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        }
+    };
+
+} // namespace dice::template_library
+
+#endif // DICE_TEMPLATELIBRARY_VECDEQUE_HPP
@@ -0,0 +1,13 @@
+#ifndef DICE_TEMPLATELIBRARY_VERSION_HPP
+#define DICE_TEMPLATELIBRARY_VERSION_HPP
+
+#include <array>
+
+namespace dice::template_library {
+    inline constexpr char name[] = "dice-template-library";
+    inline constexpr char version[] = "2.8.0";
+    inline constexpr std::array<int, 3> version_tuple = {2, 8, 0};
+    inline constexpr int pobr_version = 2; ///< persisted object binary representation version
+} // namespace dice::template_library
+
+#endif // DICE_TEMPLATELIBRARY_VERSION_HPP
@@ -0,0 +1,148 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <dice/template-library/broadcast_channel.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_SUITE("broadcast_channel") {
+	using namespace dice::template_library;
+
+	TEST_CASE("sanity check") {
+		broadcast_channel<std::string> chan;
+		REQUIRE_EQ(chan.version(), 0);
+		REQUIRE_FALSE(chan.latest().has_value());
+
+		auto sub1 = chan.subscribe();
+		auto sub2 = chan.subscribe();
+		REQUIRE_FALSE(sub1.try_pop().has_value());
+
+		REQUIRE(chan.push("a"));
+		REQUIRE_EQ(chan.version(), 1);
+
+		auto snap = sub1.try_pop();
+		REQUIRE(snap.has_value());
+		REQUIRE_EQ(snap->version, 1);
+		REQUIRE_EQ(**snap, "a");
+		REQUIRE_EQ(sub1.last_seen_version(), 1);
+
+		// each subscriber sees each version at most once
+		REQUIRE_FALSE(sub1.try_pop().has_value());
+
+		// but every subscriber sees it
+		REQUIRE_EQ(*sub2.pop()->value, "a");
+		REQUIRE_FALSE(sub2.try_pop().has_value());
+	}
+
+	TEST_CASE("latest version wins") {
+		broadcast_channel<int> chan;
+		auto sub = chan.subscribe();
+
+		chan.push(1);
+		chan.push(2);
+		chan.emplace(3);
+
+		auto snap = sub.pop();
+		REQUIRE(snap.has_value());
+		REQUIRE_EQ(snap->version, 3);
+		REQUIRE_EQ(**snap, 3);
+		REQUIRE_FALSE(sub.try_pop().has_value());
+
+		// new subscribers start with the latest value
+		auto late_sub = chan.subscribe();
+		REQUIRE_EQ(**late_sub.try_pop(), 3);
+	}
+
+	TEST_CASE("snapshots outlive newer versions") {
+		broadcast_channel<std::vector<int>> chan;
+		auto sub = chan.subscribe();
+
+		chan.push(std::vector<int>{1, 2, 3});
+		auto old_snap = sub.pop();
+		chan.push(std::vector<int>{4});
+
+		REQUIRE_EQ(old_snap->value->size(), 3);
+		REQUIRE_EQ(chan.latest()->value->size(), 1);
+		REQUIRE_EQ(chan.latest()->version, 2);
+	}
+
+	TEST_CASE("close") {
+		using namespace std::chrono_literals;
+
+		broadcast_channel<int> chan;
+		auto sub = chan.subscribe();
+		REQUIRE_EQ(sub.pop_for(5ms).error(), channel_error::timeout);
+
+		chan.push(1);
+		chan.close();
+		REQUIRE(chan.closed());
+		REQUIRE_FALSE(chan.push(2));
+		REQUIRE_EQ(chan.version(), 1);
+
+		// the latest value can still be observed after close
+		REQUIRE_EQ(**sub.pop(), 1);
+		REQUIRE_FALSE(sub.pop().has_value());
+		REQUIRE_EQ(sub.pop_for(5ms).error(), channel_error::closed);
+	}
+
+	TEST_CASE("close unblocks waiting subscribers") {
+		broadcast_channel<int> chan;
+
+		std::vector<std::jthread> readers;
+		std::atomic<int> n_done = 0;
+		for (int ix = 0; ix < 3; ++ix) {
+			readers.emplace_back([&chan, &n_done]() {
+				auto sub = chan.subscribe();
+				CHECK_FALSE(sub.pop().has_value());
+				++n_done;
+			});
+		}
+
+		chan.close();
+		readers.clear();
+		REQUIRE_EQ(n_done.load(), 3);
+	}
+
+	TEST_CASE("concurrent writer and readers") {
+		constexpr int n_readers = 4;
+		constexpr uint64_t n_versions = 10'000;
+
+		struct config {
+			uint64_t version;
+			std::vector<uint64_t> data;
+		};
+
+		broadcast_channel<config> chan;
+		std::vector<uint64_t> last_seen(n_readers);
+		{
+			std::vector<std::jthread> readers;
+			for (auto &last : last_seen) {
+				readers.emplace_back([&chan, &last]() {
+					auto sub = chan.subscribe();
+					for (auto const &snap : sub) {
+						// versions strictly increase and snapshots are never modified
+						CHECK_GT(snap.version, last);
+						CHECK_EQ(snap->version, snap.version);
+						CHECK_EQ(snap->data.size(), 8);
+						CHECK_EQ(snap->data.back(), snap.version);
+						last = snap.version;
+					}
+				});
+			}
+
+			for (uint64_t version = 1; version <= n_versions; ++version) {
+				chan.push(config{version, std::vector<uint64_t>(8, version)});
+			}
+			chan.close();
+		}
+
+		for (auto const last : last_seen) {
+			REQUIRE_EQ(last, n_versions);
+		}
+	}
+}
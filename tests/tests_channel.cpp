@@ -3,24 +3,67 @@
 
 #include <dice/template-library/channel.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <exception>
 #include <iterator>
+#include <memory>
 #include <optional>
 #include <ranges>
+#include <stdexcept>
 #include <string>
 #include <thread>
+#include <type_traits>
 #include <vector>
 
+namespace {
+	/**
+	 * Minimal coroutine type that starts eagerly and destroys itself on completion
+	 */
+	struct detached_task {
+		struct promise_type {
+			detached_task get_return_object() noexcept { return {}; }
+			std::suspend_never initial_suspend() noexcept { return {}; }
+			std::suspend_never final_suspend() noexcept { return {}; }
+			void return_void() noexcept {}
+			void unhandled_exception() noexcept { std::terminate(); }
+		};
+	};
+
+	/**
+	 * Executor that collects the coroutines that are ready to be resumed
+	 */
+	struct collecting_executor {
+		std::vector<std::coroutine_handle<>> *ready;
+
+		void operator()(std::coroutine_handle<> handle) const {
+			ready->push_back(handle);
+		}
+	};
+
+	void resume_all(std::vector<std::coroutine_handle<>> &ready) {
+		for (auto handle : std::exchange(ready, {})) {
+			handle.resume();
+		}
+	}
+} // namespace
+
 TEST_SUITE("mpmc_channel") {
 	using namespace dice::template_library;
 
-	TEST_CASE("is range") {
-		static_assert(std::input_iterator<channel<int>::iterator>);
-		static_assert(std::ranges::range<channel<int>>);
-		static_assert(std::ranges::input_range<channel<int>>);
+	using locked_queue = std::integral_constant<channel_storage, channel_storage::locked_queue>;
+	using lock_free_ring = std::integral_constant<channel_storage, channel_storage::lock_free_ring>;
+
+	TEST_CASE_TEMPLATE("is range", S, locked_queue, lock_free_ring) {
+		static_assert(std::input_iterator<typename channel<int, S::value>::iterator>);
+		static_assert(std::ranges::range<channel<int, S::value>>);
+		static_assert(std::ranges::input_range<channel<int, S::value>>);
 	}
 
-	TEST_CASE("sanity check") {
-		channel<std::string> chan{3};
+	TEST_CASE_TEMPLATE("sanity check", S, locked_queue, lock_free_ring) {
+		channel<std::string, S::value> chan{3};
 		REQUIRE_FALSE(chan.closed());
 		REQUIRE_EQ(chan.try_pop(), std::nullopt);
 
@@ -47,8 +90,8 @@ TEST_SUITE("mpmc_channel") {
 		REQUIRE_EQ(chan.try_pop(), std::nullopt);
 	}
 
-	TEST_CASE("usecase sanity check") {
-		channel<int> chan{3};
+	TEST_CASE_TEMPLATE("usecase sanity check", S, locked_queue, lock_free_ring) {
+		channel<int, S::value> chan{3};
 
 		std::jthread const thrd{[&chan]() {
 			std::vector<int> ints;
@@ -65,8 +108,8 @@ TEST_SUITE("mpmc_channel") {
 		chan.close(); // don't forget to close
 	}
 
-	TEST_CASE("iter") {
-		channel<std::string> chan{8};
+	TEST_CASE_TEMPLATE("iter", S, locked_queue, lock_free_ring) {
+		channel<std::string, S::value> chan{8};
 		chan.emplace("a");
 		chan.emplace("b");
 		chan.close();
@@ -79,8 +122,8 @@ TEST_SUITE("mpmc_channel") {
 		REQUIRE_EQ(actual, std::vector<std::string>{"a", "b"});
 	}
 
-	TEST_CASE("closed push") {
-		channel<std::string> chan{8};
+	TEST_CASE_TEMPLATE("closed push", S, locked_queue, lock_free_ring) {
+		channel<std::string, S::value> chan{8};
 		chan.close();
 		REQUIRE(chan.closed());
 
@@ -95,4 +138,516 @@ TEST_SUITE("mpmc_channel") {
 		REQUIRE_EQ(chan.pop(), std::nullopt);
 		REQUIRE_EQ(chan.try_pop(), std::nullopt);
 	}
+
+	TEST_CASE_TEMPLATE("capacity of one", S, locked_queue, lock_free_ring) {
+		channel<int, S::value> chan{1};
+		REQUIRE(chan.try_push(1));
+		REQUIRE_FALSE(chan.try_push(2));
+		REQUIRE_EQ(chan.try_pop(), 1);
+		REQUIRE(chan.try_push(2));
+		REQUIRE_EQ(chan.try_pop(), 2);
+		REQUIRE_EQ(chan.try_pop(), std::nullopt);
+	}
+
+	TEST_CASE("lock_free_ring rejects capacity of zero") {
+		REQUIRE_THROWS_AS((channel<int, channel_storage::lock_free_ring>{0}), std::invalid_argument);
+	}
+
+	TEST_CASE("throwing constructor does not block lock_free_ring") {
+		struct throws_on_negative {
+			int x;
+
+			explicit throws_on_negative(int x) : x{x} {
+				if (x < 0) {
+					throw std::runtime_error{"negative"};
+				}
+			}
+
+			throws_on_negative(throws_on_negative &&other) noexcept = default;
+			throws_on_negative &operator=(throws_on_negative &&other) noexcept = default;
+		};
+
+		channel<throws_on_negative, channel_storage::lock_free_ring> chan{2};
+		REQUIRE_THROWS(chan.emplace(-1));
+		REQUIRE(chan.try_emplace(1));
+
+		// the channel is full (the slot of the failed element is only released by the next consumer), so nothing is constructed
+		REQUIRE_FALSE(chan.try_emplace(-1));
+
+		REQUIRE_EQ(chan.try_pop()->x, 1);
+		REQUIRE_THROWS(chan.try_emplace(-1));
+		REQUIRE(chan.try_emplace(2));
+		REQUIRE_EQ(chan.try_pop()->x, 2);
+		REQUIRE_FALSE(chan.try_pop().has_value());
+
+		SUBCASE("blocked producers are woken up once the slot of a failed element is released") {
+			channel<throws_on_negative, channel_storage::lock_free_ring> chan1{1};
+			REQUIRE_THROWS(chan1.emplace(-1));
+
+			std::thread producer{[&chan1] {
+				chan1.emplace(3);
+				chan1.close();
+			}};
+
+			REQUIRE_EQ(chan1.pop()->x, 3);
+			producer.join();
+			REQUIRE_FALSE(chan1.pop().has_value());
+		}
+	}
+
+	TEST_CASE_TEMPLATE("elements are not consumed if there is no capacity", S, locked_queue, lock_free_ring) {
+		struct from_string {
+			std::string s;
+
+			explicit from_string(std::string &&s) : s{std::move(s)} {
+			}
+
+			from_string(from_string &&other) noexcept = default;
+			from_string &operator=(from_string &&other) noexcept = default;
+		};
+
+		static_assert(!std::is_nothrow_constructible_v<from_string, std::string &&>);
+
+		channel<from_string, S::value> chan{1};
+		REQUIRE(chan.try_emplace(std::string{"x"}));
+
+		std::vector<std::string> src{"a", "b"};
+		auto moved = src | std::views::transform([](std::string &str) -> std::string && { return std::move(str); });
+
+		REQUIRE_EQ(chan.try_push_range(moved), 0);
+		REQUIRE_EQ(src, std::vector<std::string>{"a", "b"});
+
+		std::string single{"c"};
+		REQUIRE_FALSE(chan.try_emplace(std::move(single)));
+		REQUIRE_EQ(single, "c");
+
+		REQUIRE_EQ(chan.try_pop()->s, "x");
+		REQUIRE_EQ(chan.try_push_range(moved), 1);
+		REQUIRE_EQ(src, std::vector<std::string>{"", "b"});
+		REQUIRE_EQ(chan.try_pop()->s, "a");
+	}
+
+	TEST_CASE_TEMPLATE("unconsumed elements are destroyed", S, locked_queue, lock_free_ring) {
+		auto const value = std::make_shared<int>(5);
+
+		{
+			channel<std::shared_ptr<int>, S::value> chan{4};
+			chan.push(value);
+			chan.push(value);
+			chan.push(value);
+			REQUIRE_EQ(chan.pop(), value);
+			REQUIRE_EQ(value.use_count(), 3);
+		}
+
+		REQUIRE_EQ(value.use_count(), 1);
+	}
+
+	TEST_CASE_TEMPLATE("multiple producers and consumers", S, locked_queue, lock_free_ring) {
+		constexpr int n_threads = 4;
+		constexpr int n_elems_per_producer = 10'000;
+
+		channel<int, S::value> chan{16};
+		std::atomic<int> n_producers_running = n_threads;
+
+		std::vector<std::jthread> producers;
+		for (int p = 0; p < n_threads; ++p) {
+			producers.emplace_back([&chan, &n_producers_running, p]() {
+				for (int x = 0; x < n_elems_per_producer; ++x) {
+					chan.push(p * n_elems_per_producer + x);
+				}
+
+				if (n_producers_running.fetch_sub(1) == 1) {
+					chan.close();
+				}
+			});
+		}
+
+		std::vector<std::vector<int>> received(n_threads);
+		{
+			std::vector<std::jthread> consumers;
+			for (auto &recv : received) {
+				consumers.emplace_back([&chan, &recv]() {
+					for (int const x : chan) {
+						recv.push_back(x);
+					}
+				});
+			}
+		}
+
+		std::vector<int> all;
+		for (auto const &recv : received) {
+			// elements of a single producer are received in order
+			for (int p = 0; p < n_threads; ++p) {
+				auto from_p = recv | std::views::filter([p](int x) { return x / n_elems_per_producer == p; });
+				REQUIRE(std::ranges::is_sorted(from_p));
+			}
+			all.insert(all.end(), recv.begin(), recv.end());
+		}
+
+		std::ranges::sort(all);
+		REQUIRE_EQ(all.size(), static_cast<size_t>(n_threads * n_elems_per_producer));
+		for (int x = 0; x < n_threads * n_elems_per_producer; ++x) {
+			REQUIRE_EQ(all[x], x);
+		}
+	}
+
+	TEST_CASE_TEMPLATE("batch push and pop", S, locked_queue, lock_free_ring) {
+		channel<int, S::value> chan{4};
+
+		std::vector<int> const elems{1, 2, 3, 4, 5, 6};
+		REQUIRE_EQ(chan.try_push_range(elems), 4); // only 4 fit
+
+		std::vector<int> out;
+		REQUIRE_EQ(chan.try_pop_batch(std::back_inserter(out), 3), 3);
+		REQUIRE_EQ(out, std::vector<int>{1, 2, 3});
+
+		REQUIRE_EQ(chan.try_push_range(elems | std::views::drop(4)), 2);
+		REQUIRE_EQ(chan.pop_batch(std::back_inserter(out), 10), 3);
+		REQUIRE_EQ(out, std::vector<int>{1, 2, 3, 4, 5, 6});
+
+		REQUIRE_EQ(chan.try_pop_batch(std::back_inserter(out), 10), 0);
+
+		chan.close();
+		REQUIRE_EQ(chan.try_push_range(elems), 0);
+		REQUIRE_EQ(chan.push_range(elems), 0);
+		REQUIRE_EQ(chan.pop_batch(std::back_inserter(out), 10), 0);
+	}
+
+	TEST_CASE_TEMPLATE("blocking push_range", S, locked_queue, lock_free_ring) {
+		static constexpr int n_elems = 1000;
+		channel<int, S::value> chan{7};
+
+		std::jthread producer{[&chan]() {
+			REQUIRE_EQ(chan.push_range(std::views::iota(0, n_elems)), static_cast<size_t>(n_elems));
+			chan.close();
+		}};
+
+		std::vector<int> out;
+		while (chan.pop_batch(std::back_inserter(out), 16) > 0) {
+		}
+
+		REQUIRE_EQ(out.size(), static_cast<size_t>(n_elems));
+		REQUIRE(std::ranges::equal(out, std::views::iota(0, n_elems)));
+	}
+
+	TEST_CASE_TEMPLATE("batched iteration", S, locked_queue, lock_free_ring) {
+		static constexpr int n_elems = 1000;
+		channel<int, S::value> chan{16};
+
+		static_assert(std::ranges::input_range<typename channel<int, S::value>::batched_view>);
+
+		std::jthread producer{[&chan]() {
+			for (int x = 0; x < n_elems; ++x) {
+				chan.push(x);
+			}
+			chan.close();
+		}};
+
+		std::vector<int> out;
+		for (int const x : chan.batched(8)) {
+			out.push_back(x);
+		}
+
+		REQUIRE(std::ranges::equal(out, std::views::iota(0, n_elems)));
+	}
+
+	TEST_CASE_TEMPLATE("timed push and pop", S, locked_queue, lock_free_ring) {
+		using namespace std::chrono_literals;
+		channel<int, S::value> chan{1};
+
+		SUBCASE("timeout") {
+			auto const r1 = chan.pop_for(1ms);
+			REQUIRE_FALSE(r1.has_value());
+			REQUIRE_EQ(r1.error(), channel_error::timeout);
+
+			REQUIRE(chan.push_for(1, 1ms).has_value());
+			auto const r2 = chan.push_until(2, std::chrono::steady_clock::now() + 1ms);
+			REQUIRE_FALSE(r2.has_value());
+			REQUIRE_EQ(r2.error(), channel_error::timeout);
+
+			auto const r3 = chan.pop_until(std::chrono::steady_clock::now() + 1ms);
+			REQUIRE(r3.has_value());
+			REQUIRE_EQ(*r3, 1);
+		}
+
+		SUBCASE("closed") {
+			REQUIRE(chan.emplace_for(1ms, 1).has_value());
+			chan.close();
+
+			auto const r1 = chan.emplace_until(std::chrono::steady_clock::now() + 1ms, 2);
+			REQUIRE_FALSE(r1.has_value());
+			REQUIRE_EQ(r1.error(), channel_error::closed);
+
+			auto const r2 = chan.pop_for(1ms);
+			REQUIRE(r2.has_value());
+			REQUIRE_EQ(*r2, 1);
+
+			auto const r3 = chan.pop_for(1ms);
+			REQUIRE_FALSE(r3.has_value());
+			REQUIRE_EQ(r3.error(), channel_error::closed);
+		}
+
+		SUBCASE("wakeup before deadline") {
+			std::jthread producer{[&chan]() {
+				std::this_thread::sleep_for(10ms);
+				chan.push(42);
+			}};
+
+			auto const r = chan.pop_for(10s);
+			REQUIRE(r.has_value());
+			REQUIRE_EQ(*r, 42);
+		}
+
+		SUBCASE("close wakes up timed pop") {
+			std::jthread closer{[&chan]() {
+				std::this_thread::sleep_for(10ms);
+				chan.close();
+			}};
+
+			auto const r = chan.pop_for(10s);
+			REQUIRE_FALSE(r.has_value());
+			REQUIRE_EQ(r.error(), channel_error::closed);
+		}
+	}
+
+	TEST_CASE("co_pop and co_push complete immediately if possible") {
+		channel<int> chan{1};
+		std::vector<std::coroutine_handle<>> ready;
+		std::optional<int> popped;
+		bool pushed = false;
+
+		auto producer = [&]() -> detached_task {
+			pushed = co_await chan.co_push(1, collecting_executor{&ready});
+		};
+		auto consumer = [&]() -> detached_task {
+			popped = co_await chan.co_pop(collecting_executor{&ready});
+		};
+
+		producer();
+		REQUIRE(pushed);
+		consumer();
+		REQUIRE_EQ(popped, std::optional<int>{1});
+		REQUIRE(ready.empty());
+	}
+
+	TEST_CASE("co_pop suspends until an element is pushed") {
+		channel<int> chan{4};
+		std::vector<std::coroutine_handle<>> ready;
+		std::optional<int> popped;
+
+		auto consumer = [&]() -> detached_task {
+			popped = co_await chan.co_pop(collecting_executor{&ready});
+		};
+
+		consumer();
+		REQUIRE_FALSE(popped.has_value());
+		REQUIRE(ready.empty());
+
+		REQUIRE(chan.push(42));
+		REQUIRE_EQ(ready.size(), 1);
+		REQUIRE_FALSE(chan.try_pop().has_value()); // the element was handed directly to the coroutine
+
+		resume_all(ready);
+		REQUIRE_EQ(popped, std::optional<int>{42});
+	}
+
+	TEST_CASE("co_push suspends until there is capacity") {
+		channel<int> chan{1};
+		std::vector<std::coroutine_handle<>> ready;
+		std::optional<bool> pushed;
+
+		REQUIRE(chan.push(1));
+
+		auto producer = [&]() -> detached_task {
+			pushed = co_await chan.co_push(2, collecting_executor{&ready});
+		};
+
+		producer();
+		REQUIRE_FALSE(pushed.has_value());
+
+		REQUIRE_EQ(chan.pop(), std::optional<int>{1});
+		REQUIRE_EQ(ready.size(), 1);
+		REQUIRE_EQ(chan.try_pop(), std::optional<int>{2}); // the element was moved into the channel by pop()
+
+		resume_all(ready);
+		REQUIRE_EQ(pushed, std::optional<bool>{true});
+	}
+
+	TEST_CASE("close resumes suspended coroutines") {
+		channel<int> empty_chan{1};
+		channel<int> full_chan{1};
+		REQUIRE(full_chan.push(1));
+
+		std::vector<std::coroutine_handle<>> ready;
+		std::optional<std::optional<int>> popped;
+		std::optional<bool> pushed;
+
+		auto consumer = [&]() -> detached_task {
+			popped = co_await empty_chan.co_pop(collecting_executor{&ready});
+		};
+		auto producer = [&]() -> detached_task {
+			pushed = co_await full_chan.co_push(2, collecting_executor{&ready});
+		};
+
+		consumer();
+		producer();
+		REQUIRE(ready.empty());
+
+		empty_chan.close();
+		full_chan.close();
+		REQUIRE_EQ(ready.size(), 2);
+
+		resume_all(ready);
+		REQUIRE(popped.has_value());
+		REQUIRE_FALSE(popped->has_value());
+		REQUIRE_EQ(pushed, std::optional<bool>{false});
+	}
+
+	TEST_CASE("coroutine pipelines on a thread pool") {
+		static constexpr int n_coros = 8;
+		static constexpr int n_elems = 500;
+
+		channel<int> chan{4};
+		channel<std::coroutine_handle<>> run_queue{2 * n_coros};
+		auto executor = [&run_queue](std::coroutine_handle<> handle) {
+			run_queue.push(handle);
+		};
+
+		std::atomic<int> producers_left = n_coros;
+		std::atomic<int> consumers_left = n_coros;
+		std::atomic<long long> sum = 0;
+
+		auto producer = [&]() -> detached_task {
+			for (int x = 0; x < n_elems; ++x) {
+				CHECK(co_await chan.co_push(x, executor));
+			}
+			if (producers_left.fetch_sub(1) == 1) {
+				chan.close();
+			}
+		};
+		auto consumer = [&]() -> detached_task {
+			while (auto x = co_await chan.co_pop(executor)) {
+				sum.fetch_add(*x);
+			}
+			if (consumers_left.fetch_sub(1) == 1) {
+				run_queue.close();
+			}
+		};
+
+		std::vector<std::jthread> workers;
+		for (int ix = 0; ix < 2; ++ix) {
+			workers.emplace_back([&run_queue]() {
+				for (auto handle : run_queue) {
+					handle.resume();
+				}
+			});
+		}
+
+		for (int ix = 0; ix < n_coros; ++ix) {
+			consumer();
+			producer();
+		}
+
+		workers.clear();
+		REQUIRE_EQ(sum.load(), static_cast<long long>(n_coros) * n_elems * (n_elems - 1) / 2);
+	}
+
+	TEST_CASE_TEMPLATE("instrumentation", S, locked_queue, lock_free_ring) {
+		using namespace std::chrono_literals;
+		channel<int, S::value, channel_instrumentation::enabled> chan{4};
+		REQUIRE_EQ(chan.stats().n_pushed, 0);
+
+		REQUIRE(chan.push(1));
+		REQUIRE(chan.push(2));
+		REQUIRE(chan.push(3));
+		REQUIRE_EQ(chan.pop(), 1);
+		REQUIRE_EQ(chan.push_range(std::vector<int>{4, 5}), 2);
+
+		std::vector<int> out;
+		REQUIRE_EQ(chan.pop_batch(std::back_inserter(out), 2), 2);
+
+		auto stats = chan.stats();
+		REQUIRE_EQ(stats.n_pushed, 5);
+		REQUIRE_EQ(stats.n_popped, 3);
+		REQUIRE_EQ(stats.n_dropped, 0);
+		REQUIRE_EQ(stats.high_water_mark, 4);
+		REQUIRE_EQ(stats.pop_wait_time, 0ns);
+		REQUIRE_EQ(stats.push_wait_time, 0ns);
+
+		// drain, then block a consumer until an element arrives
+		while (chan.try_pop().has_value()) {
+		}
+
+		std::jthread producer{[&chan]() {
+			std::this_thread::sleep_for(20ms);
+			chan.push(6);
+		}};
+
+		REQUIRE_EQ(chan.pop(), 6);
+		stats = chan.stats();
+		REQUIRE_EQ(stats.n_pushed, 6);
+		REQUIRE_EQ(stats.n_popped, 6);
+		REQUIRE_GT(stats.pop_wait_time, 0ns);
+	}
+
+	TEST_CASE("wait policies that never spin block right away") {
+		static_assert(!detail_channel::wait_policy_spins<park_wait_policy>);
+		static_assert(!detail_channel::wait_policy_spins<spin_wait_policy<0, 0>>);
+		static_assert(detail_channel::wait_policy_spins<spin_wait_policy<>>);
+		static_assert(detail_channel::wait_policy_spins<adaptive_wait_policy<>>);
+	}
+
+	TEST_CASE_TEMPLATE("wait policies", P, park_wait_policy, spin_wait_policy<>, spin_wait_policy<0, 0>, adaptive_wait_policy<>, adaptive_wait_policy<1, 1, 0>) {
+		constexpr int n_threads = 2;
+		constexpr int n_elems_per_producer = 10'000;
+
+		auto run = [&]<channel_storage storage>(std::integral_constant<channel_storage, storage>) {
+			channel<int, storage, channel_instrumentation::disabled, P> chan{4};
+			std::atomic<int> n_producers_running = n_threads;
+
+			std::vector<std::jthread> producers;
+			for (int p = 0; p < n_threads; ++p) {
+				producers.emplace_back([&chan, &n_producers_running, p]() {
+					for (int x = 0; x < n_elems_per_producer; ++x) {
+						chan.push(p * n_elems_per_producer + x);
+					}
+
+					if (n_producers_running.fetch_sub(1) == 1) {
+						chan.close();
+					}
+				});
+			}
+
+			std::atomic<long long> sum = 0;
+			{
+				std::vector<std::jthread> consumers;
+				for (int c = 0; c < n_threads; ++c) {
+					consumers.emplace_back([&chan, &sum]() {
+						for (int const x : chan) {
+							sum.fetch_add(x, std::memory_order_relaxed);
+						}
+					});
+				}
+			}
+
+			constexpr long long n = n_threads * n_elems_per_producer;
+			REQUIRE_EQ(sum.load(), n * (n - 1) / 2);
+		};
+
+		run(locked_queue{});
+		run(lock_free_ring{});
+	}
+
+	TEST_CASE("wait policies with timeouts") {
+		using namespace std::chrono_literals;
+		channel<int, channel_storage::locked_queue, channel_instrumentation::disabled, spin_wait_policy<>> chan{1};
+		REQUIRE_EQ(chan.pop_for(5ms).error(), channel_error::timeout);
+		REQUIRE(chan.push(1));
+		REQUIRE_EQ(chan.push_for(2, 5ms).error(), channel_error::timeout);
+
+		channel<int, channel_storage::lock_free_ring, channel_instrumentation::disabled, adaptive_wait_policy<>> ring{1};
+		REQUIRE_EQ(ring.pop_for(5ms).error(), channel_error::timeout);
+		REQUIRE(ring.push(1));
+		REQUIRE_EQ(ring.push_for(2, 5ms).error(), channel_error::timeout);
+	}
 }
@@ -3,9 +3,28 @@
 
 #include <dice/template-library/exchange_channel.hpp>
 
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <set>
 #include <thread>
+#include <type_traits>
 #include <vector>
 
+namespace {
+    struct detached_task {
+        struct promise_type {
+            detached_task get_return_object() noexcept { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() noexcept {}
+            void unhandled_exception() noexcept { std::terminate(); }
+        };
+    };
+}  // namespace
+
 TEST_SUITE("exchange_channel") {
     TEST_CASE("sanity check") {
         dice::template_library::exchange_channel<int> w;
@@ -120,4 +139,184 @@ TEST_SUITE("exchange_channel") {
         }
         producer.join();
     }
-}
\ No newline at end of file
+    TEST_CASE("timed pop") {
+        using namespace std::chrono_literals;
+        dice::template_library::exchange_channel<int> ch;
+
+        auto r = ch.pop_for(1ms);
+        REQUIRE_FALSE(r.has_value());
+        CHECK_EQ(r.error(), dice::template_library::channel_error::timeout);
+
+        ch.push(5);
+        r = ch.pop_until(std::chrono::steady_clock::now() + 1ms);
+        REQUIRE(r.has_value());
+        CHECK_EQ(*r, 5);
+
+        std::thread closer{[&ch] {
+            std::this_thread::sleep_for(10ms);
+            ch.close();
+        }};
+
+        r = ch.pop_for(10s);
+        closer.join();
+        REQUIRE_FALSE(r.has_value());
+        CHECK_EQ(r.error(), dice::template_library::channel_error::closed);
+    }
+
+    TEST_CASE("co_pop suspends until a value is pushed") {
+        dice::template_library::exchange_channel<int> ch;
+        std::vector<std::coroutine_handle<>> ready;
+        auto executor = [&ready](std::coroutine_handle<> handle) { ready.push_back(handle); };
+
+        std::optional<int> popped;
+        bool pushed = false;
+        auto consumer = [&]() -> detached_task {
+            popped = co_await ch.co_pop(executor);
+        };
+        auto producer = [&]() -> detached_task {
+            pushed = co_await ch.co_push(3, executor);
+        };
+
+        consumer();
+        CHECK_FALSE(popped.has_value());
+
+        producer();
+        CHECK(pushed);
+        REQUIRE_EQ(ready.size(), 1);
+        CHECK_FALSE(ch.try_pop().has_value());  // the value was handed directly to the coroutine
+
+        ready.front().resume();
+        CHECK_EQ(popped, std::optional<int>{3});
+    }
+
+    TEST_CASE("close resumes suspended co_pop") {
+        dice::template_library::exchange_channel<int> ch;
+        std::vector<std::coroutine_handle<>> ready;
+        auto executor = [&ready](std::coroutine_handle<> handle) { ready.push_back(handle); };
+
+        bool done = false;
+        std::optional<int> popped{-1};
+        auto consumer = [&]() -> detached_task {
+            popped = co_await ch.co_pop(executor);
+            done = true;
+        };
+
+        consumer();
+        ch.close();
+        REQUIRE_EQ(ready.size(), 1);
+
+        ready.front().resume();
+        CHECK(done);
+        CHECK_FALSE(popped.has_value());
+    }
+
+    TEST_CASE("instrumentation") {
+        using namespace std::chrono_literals;
+        using dice::template_library::channel_instrumentation;
+
+        dice::template_library::exchange_channel<int, channel_instrumentation::enabled> ch;
+        ch.push(1);
+        ch.push(2);  // drops 1
+        ch.push(3);  // drops 2
+        CHECK_EQ(ch.pop(), std::optional<int>{3});
+
+        auto const stats = ch.stats();
+        CHECK_EQ(stats.n_pushed, 3);
+        CHECK_EQ(stats.n_popped, 1);
+        CHECK_EQ(stats.n_dropped, 2);
+        CHECK_EQ(stats.high_water_mark, 1);
+        CHECK_EQ(stats.push_wait_time, 0ns);
+    }
+
+    TEST_CASE_TEMPLATE("wait policies", P, dice::template_library::park_wait_policy, dice::template_library::spin_wait_policy<>, dice::template_library::adaptive_wait_policy<>) {
+        dice::template_library::exchange_channel<int, dice::template_library::channel_instrumentation::disabled, P> ch;
+
+        std::thread producer{[&ch] {
+            for (int i = 0; i < 1000; ++i) {
+                ch.push(i);
+            }
+            ch.close();
+        }};
+
+        int last = -1;
+        while (auto v = ch.pop()) {
+            CHECK(*v > last);
+            last = *v;
+        }
+        producer.join();
+        CHECK_EQ(last, 999);
+    }
+
+    TEST_CASE("non-assignable value type") {
+        using namespace dice::template_library;
+
+        struct non_assignable {
+            int const x;
+
+            explicit non_assignable(int x) noexcept : x{x} {
+            }
+
+            non_assignable(non_assignable &&other) noexcept = default;
+            non_assignable &operator=(non_assignable &&other) = delete;
+        };
+
+        static_assert(!std::is_move_assignable_v<non_assignable>);
+
+        exchange_channel<non_assignable, channel_instrumentation::enabled> ch;
+        ch.emplace(1);
+        ch.push(non_assignable{2});  // drops 1
+        ch.emplace(3);  // drops 2
+        CHECK_EQ(ch.pop()->x, 3);
+        CHECK_EQ(ch.stats().n_dropped, 2);
+    }
+
+    TEST_CASE("merge function combines unconsumed values") {
+        using namespace dice::template_library;
+
+        exchange_channel<int, channel_instrumentation::enabled, adaptive_wait_policy<>, std::plus<>> ch;
+        ch.push(1);
+        ch.push(2);
+        ch.emplace(3);
+        CHECK_EQ(ch.try_pop(), 6);
+        CHECK_FALSE(ch.try_pop().has_value());
+
+        // merged values are not dropped
+        CHECK_EQ(ch.stats().n_dropped, 0);
+
+        ch.push(4);
+        CHECK_EQ(ch.pop(), 4);
+    }
+
+    TEST_CASE("in place merge function") {
+        using namespace dice::template_library;
+
+        auto merge_sets = [](std::set<int> &current, std::set<int> &&incoming) {
+            current.merge(incoming);
+        };
+
+        exchange_channel<std::set<int>, channel_instrumentation::disabled, adaptive_wait_policy<>, decltype(merge_sets)> ch{merge_sets};
+        ch.push(std::set<int>{1, 2});
+        ch.push(std::set<int>{2, 3});
+        CHECK_EQ(ch.pop(), std::set<int>{1, 2, 3});
+    }
+
+    TEST_CASE("no update is lost with a merge function") {
+        using namespace dice::template_library;
+
+        exchange_channel<long, channel_instrumentation::disabled, adaptive_wait_policy<>, std::plus<>> ch;
+
+        std::thread producer{[&ch] {
+            for (long i = 1; i <= 10'000; ++i) {
+                ch.push(i);
+            }
+            ch.close();
+        }};
+
+        long sum = 0;
+        while (auto v = ch.pop()) {
+            sum += *v;
+        }
+        producer.join();
+        CHECK_EQ(sum, 10'000L * 10'001 / 2);
+    }
+}
@@ -0,0 +1,99 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <dice/template-library/lock_all.hpp>
+#include <dice/template-library/spin_futex_mutex.hpp>
+
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+TEST_SUITE("lock_all") {
+	using namespace dice::template_library;
+
+	TEST_CASE("single object") {
+		mutex<int> a{1};
+
+		auto [ga] = lock_all(a);
+		static_assert(std::is_same_v<decltype(ga), mutex_guard<int>>);
+		REQUIRE_EQ(*ga, 1);
+		REQUIRE_FALSE(a.try_lock().has_value());
+	}
+
+	TEST_CASE("mixed objects") {
+		mutex<int> a{1};
+		shared_mutex<double> b{2.0};
+		mutex<int, spin_futex_mutex> c{3};
+
+		{
+			auto [ga, gb, gc] = lock_all(a, b, c);
+			static_assert(std::is_same_v<decltype(gb), shared_mutex_guard<double>>);
+			static_assert(std::is_same_v<decltype(gc), mutex_guard<int, spin_futex_mutex>>);
+
+			REQUIRE_FALSE(a.try_lock().has_value());
+			REQUIRE_FALSE(b.try_lock_shared().has_value());
+			REQUIRE_FALSE(c.try_lock().has_value());
+
+			*ga += 10;
+			*gb += 10.0;
+			*gc += 10;
+		}
+
+		REQUIRE_EQ(*a.lock(), 11);
+		REQUIRE_EQ(*b.lock_shared(), 12.0);
+		REQUIRE_EQ(*c.lock(), 13);
+	}
+
+	TEST_CASE("try_lock_all") {
+		mutex<int> a{1};
+		shared_mutex<int> b{2};
+
+		{
+			auto guards = try_lock_all(a, b);
+			REQUIRE(guards.has_value());
+			REQUIRE_EQ(*std::get<0>(*guards), 1);
+			REQUIRE_EQ(*std::get<1>(*guards), 2);
+
+			REQUIRE_FALSE(try_lock_all(a).has_value());
+		}
+
+		{
+			// if one object cannot be locked, none are locked
+			auto gb = b.lock_shared();
+			REQUIRE_FALSE(try_lock_all(a, b).has_value());
+			REQUIRE(a.try_lock().has_value());
+		}
+
+		REQUIRE(try_lock_all(b, a).has_value());
+	}
+
+	TEST_CASE("no deadlock when locking in different orders") {
+		mutex<int> a{0};
+		mutex<int> b{0};
+		shared_mutex<int> c{0};
+
+		auto transfer = [](auto &from, auto &to) {
+			for (int ix = 0; ix < 10000; ++ix) {
+				auto [gf, gt] = lock_all(from, to);
+				--*gf;
+				++*gt;
+			}
+		};
+
+		std::vector<std::thread> threads;
+		threads.emplace_back([&]() { transfer(a, b); });
+		threads.emplace_back([&]() { transfer(b, c); });
+		threads.emplace_back([&]() { transfer(c, a); });
+		threads.emplace_back([&]() { transfer(b, a); });
+
+		for (auto &t : threads) {
+			t.join();
+		}
+
+		// no transfer was lost
+		auto [ga, gb, gc] = lock_all(a, b, c);
+		REQUIRE_EQ(*ga, 10000);
+		REQUIRE_EQ(*gb, -10000);
+		REQUIRE_EQ(*gc, 0);
+	}
+}
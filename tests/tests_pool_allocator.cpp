@@ -3,9 +3,11 @@
 
 #include <dice/template-library/pool_allocator.hpp>
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
 #include <type_traits>
+#include <vector>
 
 TEST_SUITE("pool allocator") {
 	TEST_CASE("basic pool functions work") {
@@ -36,6 +38,241 @@ TEST_SUITE("pool allocator") {
 		pool.deallocate(ptr4, sizeof(std::array<long, 2>));
 	}
 
+	template<size_t ...bucket_sizes>
+	void check_all_sizes() {
+		dice::template_library::pool<bucket_sizes...> pool;
+		constexpr size_t max_bucket_size = std::max({bucket_sizes...});
+
+		for (size_t n_bytes = 1; n_bytes <= max_bucket_size + 1; n_bytes += std::max<size_t>(1, n_bytes / 64)) {
+			auto *a = static_cast<std::byte *>(pool.allocate(n_bytes));
+			auto *b = static_cast<std::byte *>(pool.allocate(n_bytes));
+			std::fill_n(a, n_bytes, std::byte{1});
+			std::fill_n(b, n_bytes, std::byte{2});
+
+			REQUIRE(std::all_of(a, a + n_bytes, [](auto x) { return x == std::byte{1}; }));
+			REQUIRE(std::all_of(b, b + n_bytes, [](auto x) { return x == std::byte{2}; }));
+
+			pool.deallocate(a, n_bytes);
+			pool.deallocate(b, n_bytes);
+		}
+	}
+
+	TEST_CASE("bucket selection") {
+		// power of two buckets
+		check_all_sizes<8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192, 16384>();
+
+		// buckets that are not multiples of each other
+		check_all_sizes<3, 7, 12, 100>();
+		check_all_sizes<24, 40, 56>();
+
+		// duplicate buckets
+		check_all_sizes<8, 8, 16>();
+
+		// too fine-grained for a lookup table
+		check_all_sizes<1, 100'003>();
+	}
+
+	TEST_CASE("stats") {
+		dice::template_library::pool<8, 16> pool;
+
+		auto stats = pool.stats();
+		REQUIRE_EQ(stats.buckets[0].bucket_size, 8);
+		REQUIRE_EQ(stats.buckets[1].bucket_size, 16);
+		REQUIRE_EQ(stats.buckets[0].reserved_bytes, 0);
+		REQUIRE_EQ(stats.n_fallback_allocations, 0);
+
+		auto *a = pool.allocate(4);
+		auto *b = pool.allocate(8);
+		auto *c = pool.allocate(12);
+		auto *d = pool.allocate(100);
+
+		stats = pool.stats();
+		REQUIRE_EQ(stats.buckets[0].n_allocations, 2);
+		REQUIRE_EQ(stats.buckets[0].n_live, 2);
+		REQUIRE_EQ(stats.buckets[0].peak_n_live, 2);
+		REQUIRE_GE(stats.buckets[0].reserved_bytes, 2 * 8);
+		REQUIRE_EQ(stats.buckets[1].n_allocations, 1);
+		REQUIRE_EQ(stats.buckets[1].n_live, 1);
+		REQUIRE_GE(stats.buckets[1].reserved_bytes, 16);
+		REQUIRE_EQ(stats.n_fallback_allocations, 1);
+		REQUIRE_EQ(stats.n_live_fallback_allocations, 1);
+		REQUIRE_EQ(stats.live_fallback_bytes, 100);
+		REQUIRE_EQ(stats.peak_live_fallback_bytes, 100);
+
+		pool.deallocate(a, 4);
+		pool.deallocate(b, 8);
+		pool.deallocate(c, 12);
+		pool.deallocate(d, 100);
+
+		auto const reserved = stats.buckets[0].reserved_bytes;
+		stats = pool.stats();
+		REQUIRE_EQ(stats.buckets[0].n_allocations, 2);
+		REQUIRE_EQ(stats.buckets[0].n_live, 0);
+		REQUIRE_EQ(stats.buckets[0].peak_n_live, 2);
+		REQUIRE_EQ(stats.buckets[0].reserved_bytes, reserved); // chunks are kept for reuse
+		REQUIRE_EQ(stats.buckets[1].n_live, 0);
+		REQUIRE_EQ(stats.n_fallback_allocations, 1);
+		REQUIRE_EQ(stats.n_live_fallback_allocations, 0);
+		REQUIRE_EQ(stats.live_fallback_bytes, 0);
+		REQUIRE_EQ(stats.peak_live_fallback_bytes, 100);
+	}
+
+	TEST_CASE("stats via allocator") {
+		dice::template_library::pool_allocator<uint64_t, 8, 16> alloc;
+		std::vector<uint64_t, decltype(alloc)> vec(alloc);
+		vec.push_back(1);
+
+		auto const stats = alloc.underlying_pool()->stats();
+		REQUIRE_EQ(stats.buckets[0].n_live, 1);
+	}
+
+	TEST_CASE("release_unused") {
+		dice::template_library::pool<8, 16> pool;
+		REQUIRE_FALSE(pool.release_unused());
+
+		std::vector<uint64_t *> ptrs;
+		for (size_t ix = 0; ix < 10'000; ++ix) {
+			ptrs.push_back(static_cast<uint64_t *>(pool.allocate(8)));
+			*ptrs.back() = ix;
+		}
+		auto const peak_reserved = pool.stats().buckets[0].reserved_bytes;
+		REQUIRE_GE(peak_reserved, 10'000 * 8);
+
+		// deallocate in an order that scrambles the free list, keep every 1000th allocation alive
+		std::vector<uint64_t *> live;
+		for (size_t ix = 0; ix < ptrs.size(); ++ix) {
+			auto *ptr = ptrs[(ix * 7919) % ptrs.size()];
+			if (*ptr % 1000 == 0) {
+				live.push_back(ptr);
+			} else {
+				pool.deallocate(ptr, 8);
+			}
+		}
+		REQUIRE_EQ(live.size(), 10);
+		REQUIRE_EQ(pool.stats().buckets[0].reserved_bytes, peak_reserved);
+
+		REQUIRE(pool.release_unused());
+		auto const trimmed_reserved = pool.stats().buckets[0].reserved_bytes;
+		REQUIRE_LT(trimmed_reserved, peak_reserved);
+
+		// live allocations are untouched
+		for (auto *ptr : live) {
+			REQUIRE_EQ(*ptr % 1000, 0);
+		}
+
+		// remaining free chunks can still be used
+		std::vector<void *> more;
+		for (size_t ix = 0; ix < 1000; ++ix) {
+			more.push_back(pool.allocate(8));
+		}
+		for (auto *ptr : more) {
+			pool.deallocate(ptr, 8);
+		}
+
+		for (auto *ptr : live) {
+			pool.deallocate(ptr, 8);
+		}
+		REQUIRE(pool.release_unused());
+		REQUIRE_EQ(pool.stats().buckets[0].reserved_bytes, 0);
+
+		// the pool is still usable
+		auto *ptr = pool.allocate(8);
+		pool.deallocate(ptr, 8);
+	}
+
+	TEST_CASE("automatic trimming") {
+		dice::template_library::pool<8> pool{dice::template_library::pool_config{.max_free_chunks = 128}};
+
+		for (size_t round = 0; round < 3; ++round) {
+			std::vector<void *> ptrs;
+			for (size_t ix = 0; ix < 10'000; ++ix) {
+				ptrs.push_back(pool.allocate(8));
+			}
+			for (auto *ptr : ptrs) {
+				pool.deallocate(ptr, 8);
+			}
+
+			// after the peak, memory is returned without calling release_unused()
+			REQUIRE_LT(pool.stats().buckets[0].reserved_bytes, 10'000 * 8);
+		}
+	}
+
+	TEST_CASE("block growth") {
+		using dice::template_library::pool_config;
+		constexpr size_t n_allocs = 100'000;
+		constexpr size_t needed_bytes = n_allocs * 64;
+
+		SUBCASE("constant growth") {
+			dice::template_library::pool<64> pool{pool_config{.initial_block_chunks = 1, .growth_factor = 1.0}};
+
+			for (size_t ix = 0; ix < n_allocs; ++ix) {
+				[[maybe_unused]] auto *ptr = pool.allocate(64);
+			}
+
+			// one slab at a time, i.e. at most one slab of unused memory (and a small overhead per slab)
+			auto const reserved = pool.stats().buckets[0].reserved_bytes;
+			REQUIRE_GE(reserved, needed_bytes);
+			REQUIRE_LE(reserved, needed_bytes + needed_bytes / 100 + 64 * 1024);
+		}
+
+		SUBCASE("capped growth") {
+			dice::template_library::pool<64> pool{pool_config{.initial_block_chunks = 1, .growth_factor = 3.0, .max_block_bytes = 4 * 64 * 1024}};
+
+			for (size_t ix = 0; ix < n_allocs; ++ix) {
+				[[maybe_unused]] auto *ptr = pool.allocate(64);
+			}
+
+			auto const reserved = pool.stats().buckets[0].reserved_bytes;
+			REQUIRE_GE(reserved, needed_bytes);
+			REQUIRE_LE(reserved, needed_bytes + needed_bytes / 100 + 4 * 64 * 1024);
+		}
+	}
+
+	TEST_CASE("small footprint") {
+		dice::template_library::pool<8, 16> pool;
+		auto *ptr = pool.allocate(8);
+
+		// a single page for the used bucket, nothing for the other
+		auto const stats = pool.stats();
+		REQUIRE_EQ(stats.buckets[0].reserved_bytes, 4096);
+		REQUIRE_EQ(stats.buckets[1].reserved_bytes, 0);
+
+		pool.deallocate(ptr, 8);
+	}
+
+	TEST_CASE("huge pages") {
+		constexpr size_t huge_page_size = size_t{2} * 1024 * 1024;
+		dice::template_library::pool<8, 64> pool{dice::template_library::pool_config{.huge_pages = true}};
+
+		std::vector<uint64_t *> ptrs;
+		for (size_t ix = 0; ix < 100'000; ++ix) {
+			ptrs.push_back(static_cast<uint64_t *>(pool.allocate(64)));
+			*ptrs.back() = ix;
+		}
+		REQUIRE_EQ(pool.stats().buckets[1].reserved_bytes % huge_page_size, 0);
+
+		for (size_t ix = 0; ix < ptrs.size(); ++ix) {
+			REQUIRE_EQ(*ptrs[ix], ix);
+			pool.deallocate(ptrs[ix], 64);
+		}
+
+		pool.deallocate(pool.allocate(8), 8);
+	}
+
+	TEST_CASE("purge_memory") {
+		dice::template_library::pool_allocator<uint64_t, 8, 16> alloc{dice::template_library::pool_config{}};
+		auto *ptr = alloc.allocate(1);
+		alloc.deallocate(ptr, 1);
+
+		REQUIRE_GT(alloc.underlying_pool()->stats().buckets[0].reserved_bytes, 0);
+		alloc.underlying_pool()->purge_memory();
+		REQUIRE_EQ(alloc.underlying_pool()->stats().buckets[0].reserved_bytes, 0);
+
+		ptr = alloc.allocate(1);
+		*ptr = 5;
+		alloc.deallocate(ptr, 1);
+	}
+
 	TEST_CASE("many allocations and deallocations") {
 		dice::template_library::pool_allocator<std::byte, 8, 16> const alloc;
 		dice::template_library::pool_allocator<uint64_t, 8, 16> alloc1 = alloc; // first pool
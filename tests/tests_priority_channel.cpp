@@ -0,0 +1,169 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <dice/template-library/priority_channel.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <ranges>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_SUITE("priority_channel") {
+	using namespace dice::template_library;
+
+	TEST_CASE("is range") {
+		static_assert(std::input_iterator<priority_channel<int>::iterator>);
+		static_assert(std::ranges::input_range<priority_channel<int>>);
+		static_assert(std::ranges::input_range<priority_channel<int>::batched_view>);
+	}
+
+	TEST_CASE("sanity check") {
+		priority_channel<std::string> chan{3};
+		REQUIRE_FALSE(chan.closed());
+		REQUIRE_EQ(chan.try_pop(), std::nullopt);
+
+		std::string const s{"b"};
+		chan.push(s);
+		chan.push(std::string{"c"});
+		chan.emplace("a");
+
+		// no capacity left
+		REQUIRE_FALSE(chan.try_push(s));
+		REQUIRE_FALSE(chan.try_push(std::string{"d"}));
+		REQUIRE_FALSE(chan.try_emplace("d"));
+
+		chan.close();
+		REQUIRE(chan.closed());
+
+		REQUIRE_EQ(chan.pop(), "c");
+		REQUIRE_EQ(chan.pop(), "b");
+		REQUIRE_EQ(chan.pop(), "a");
+		REQUIRE_EQ(chan.pop(), std::nullopt);
+		REQUIRE_EQ(chan.try_pop(), std::nullopt);
+	}
+
+	TEST_CASE("custom compare") {
+		priority_channel<int, std::greater<>> chan{8};
+		for (int const x : {5, 3, 7, 1}) {
+			REQUIRE(chan.push(x));
+		}
+
+		REQUIRE_EQ(chan.pop(), 1);
+		REQUIRE_EQ(chan.pop(), 3);
+		REQUIRE_EQ(chan.pop(), 5);
+		REQUIRE_EQ(chan.pop(), 7);
+	}
+
+	TEST_CASE("pops in priority order") {
+		static constexpr int n_elems = 1000;
+		priority_channel<int> chan{n_elems};
+
+		std::vector<int> elems(n_elems);
+		std::iota(elems.begin(), elems.end(), 0);
+		std::ranges::shuffle(elems, std::mt19937{42});
+
+		for (int const x : elems) {
+			REQUIRE(chan.try_push(x));
+		}
+		chan.close();
+
+		std::vector<int> out;
+		for (int const x : chan) {
+			out.push_back(x);
+		}
+
+		REQUIRE(std::ranges::equal(out, std::views::iota(0, n_elems) | std::views::reverse));
+	}
+
+	TEST_CASE("batch pop") {
+		priority_channel<int> chan{16};
+		for (int const x : {4, 8, 1, 9, 3, 6}) {
+			REQUIRE(chan.push(x));
+		}
+
+		std::vector<int> out;
+		REQUIRE_EQ(chan.pop_batch(std::back_inserter(out), 4), 4);
+		REQUIRE_EQ(out, std::vector<int>{9, 8, 6, 4});
+
+		out.clear();
+		REQUIRE_EQ(chan.try_pop_batch(std::back_inserter(out), 4), 2);
+		REQUIRE_EQ(out, std::vector<int>{3, 1});
+		REQUIRE_EQ(chan.try_pop_batch(std::back_inserter(out), 4), 0);
+
+		chan.push(2);
+		chan.close();
+		out.clear();
+		for (int const x : chan.batched(8)) {
+			out.push_back(x);
+		}
+		REQUIRE_EQ(out, std::vector<int>{2});
+	}
+
+	TEST_CASE("closed push") {
+		priority_channel<std::string> chan{8};
+		chan.close();
+
+		REQUIRE_FALSE(chan.push(std::string{"a"}));
+		REQUIRE_FALSE(chan.try_push(std::string{"a"}));
+		REQUIRE_FALSE(chan.emplace("a"));
+		REQUIRE_EQ(chan.pop(), std::nullopt);
+	}
+
+	TEST_CASE("unconsumed elements are destroyed") {
+		auto const value = std::make_shared<int>(5);
+
+		{
+			priority_channel<std::shared_ptr<int>> chan{4};
+			chan.push(value);
+			chan.push(value);
+			REQUIRE_EQ(value.use_count(), 3);
+		}
+
+		REQUIRE_EQ(value.use_count(), 1);
+	}
+
+	TEST_CASE("multiple producers and consumers") {
+		static constexpr size_t n_threads = 4;
+		static constexpr int n_elems = 20'000;
+		priority_channel<int> chan{8};
+
+		std::atomic<size_t> n_producers_running = n_threads;
+		std::vector<std::vector<int>> received(n_threads);
+
+		{
+			std::vector<std::jthread> threads;
+			for (size_t ix = 0; ix < n_threads; ++ix) {
+				threads.emplace_back([&chan, &n_producers_running, ix]() {
+					for (int x = static_cast<int>(ix); x < n_elems; x += static_cast<int>(n_threads)) {
+						REQUIRE(chan.push(x));
+					}
+
+					if (n_producers_running.fetch_sub(1) == 1) {
+						chan.close();
+					}
+				});
+
+				threads.emplace_back([&chan, &received, ix]() {
+					for (int const x : chan) {
+						received[ix].push_back(x);
+					}
+				});
+			}
+		}
+
+		std::vector<int> all;
+		for (auto const &r : received) {
+			all.insert(all.end(), r.begin(), r.end());
+		}
+		std::ranges::sort(all);
+		REQUIRE(std::ranges::equal(all, std::views::iota(0, n_elems)));
+	}
+}
@@ -0,0 +1,142 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <dice/template-library/rcu.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace {
+	/**
+	 * Counts live instances, to check that all versions are reclaimed
+	 */
+	struct counted {
+		static inline std::atomic<int> n_alive = 0;
+		int value;
+
+		explicit counted(int value) noexcept : value{value} {
+			++n_alive;
+		}
+
+		counted(counted const &other) noexcept : value{other.value} {
+			++n_alive;
+		}
+
+		~counted() {
+			--n_alive;
+		}
+	};
+} // namespace
+
+TEST_SUITE("rcu") {
+	using namespace dice::template_library;
+
+	static_assert(!std::is_copy_constructible_v<rcu<int>>);
+	static_assert(!std::is_move_constructible_v<rcu<int>>);
+	static_assert(!std::is_copy_assignable_v<rcu<int>>);
+	static_assert(std::is_move_constructible_v<rcu_guard<int>>);
+	static_assert(!std::is_copy_constructible_v<rcu_guard<int>>);
+
+	TEST_CASE("construction") {
+		rcu<int> a;
+		REQUIRE_EQ(*a.read(), 0);
+
+		rcu<std::vector<int>> b{std::vector<int>{1, 2, 3}};
+		REQUIRE_EQ(b.read()->size(), 3);
+
+		rcu<std::pair<int, double>> c{std::in_place, 5, 12.2};
+		REQUIRE_EQ(c.read()->first, 5);
+		REQUIRE_EQ(c.read()->second, 12.2);
+	}
+
+	TEST_CASE("store and update") {
+		rcu<std::map<std::string, int>> table;
+		table.store({{"a", 1}});
+		REQUIRE_EQ(table.read()->at("a"), 1);
+
+		table.update([](auto &map) { map["b"] = 2; });
+		auto guard = table.read();
+		REQUIRE_EQ(guard->size(), 2);
+		REQUIRE_EQ((*guard).at("b"), 2);
+	}
+
+	TEST_CASE("guards keep their version alive") {
+		{
+			rcu<counted> value{counted{1}};
+			auto guard = value.read();
+
+			std::jthread writer{[&value]() {
+				value.update([](counted &c) { c.value = 2; });
+			}};
+
+			// the writer waits for the grace period, i.e. until guard is released
+			std::this_thread::sleep_for(std::chrono::milliseconds{10});
+			REQUIRE_EQ(guard->value, 1);
+			REQUIRE_EQ(counted::n_alive.load(), 2);
+
+			auto moved = std::move(guard);
+			REQUIRE_EQ(moved->value, 1);
+			{
+				[[maybe_unused]] auto released = std::move(moved);
+			}
+
+			writer.join();
+			REQUIRE_EQ(counted::n_alive.load(), 1);
+			REQUIRE_EQ(value.read()->value, 2);
+		}
+		REQUIRE_EQ(counted::n_alive.load(), 0);
+	}
+
+	TEST_CASE("concurrent readers and writers") {
+		constexpr int n_readers = 4;
+		constexpr int n_writers = 2;
+		constexpr int n_updates = 500;
+
+		// fewer stripes than threads, so that stripes are shared
+		rcu<std::vector<int>, 2> value{std::vector<int>(16, 0)};
+		std::atomic<bool> done = false;
+
+		{
+			std::vector<std::jthread> readers;
+			for (int ix = 0; ix < n_readers; ++ix) {
+				readers.emplace_back([&value, &done]() {
+					int last = 0;
+					while (!done.load()) {
+						auto guard = value.read();
+						// a version is never modified after it was published
+						for (int const x : *guard) {
+							CHECK_EQ(x, guard->front());
+						}
+						CHECK_GE(guard->front(), last);
+						last = guard->front();
+					}
+				});
+			}
+
+			{
+				std::vector<std::jthread> writers;
+				for (int ix = 0; ix < n_writers; ++ix) {
+					writers.emplace_back([&value]() {
+						for (int it = 0; it < n_updates; ++it) {
+							value.update([](std::vector<int> &vec) {
+								for (int &x : vec) {
+									++x;
+								}
+							});
+						}
+					});
+				}
+			}
+
+			done = true;
+		}
+
+		REQUIRE_EQ(value.read()->back(), n_writers * n_updates);
+	}
+}
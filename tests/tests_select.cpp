@@ -0,0 +1,138 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <dice/template-library/channel.hpp>
+#include <dice/template-library/exchange_channel.hpp>
+#include <dice/template-library/select.hpp>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+TEST_SUITE("select") {
+	using namespace dice::template_library;
+	using namespace std::chrono_literals;
+
+	TEST_CASE("returns available element and its channel index") {
+		channel<int> a{4};
+		channel<std::string, channel_storage::lock_free_ring> b{4};
+		exchange_channel<double> c;
+
+		b.push("hello");
+		auto r1 = select(a, b, c);
+		REQUIRE(r1.has_value());
+		REQUIRE_EQ(r1->index(), 1);
+		REQUIRE_EQ(std::get<1>(*r1), "hello");
+
+		a.push(1);
+		c.push(2.5);
+		auto r2 = select(a, b, c);
+		REQUIRE(r2.has_value());
+		REQUIRE_EQ(r2->index(), 0); // earlier channels take precedence
+		REQUIRE_EQ(std::get<0>(*r2), 1);
+
+		auto r3 = select(a, b, c);
+		REQUIRE(r3.has_value());
+		REQUIRE_EQ(r3->index(), 2);
+		REQUIRE_EQ(std::get<2>(*r3), 2.5);
+	}
+
+	TEST_CASE("same value types are distinguished by index") {
+		channel<int> a{4};
+		channel<int> b{4};
+
+		b.push(42);
+		auto r = select(a, b);
+		REQUIRE(r.has_value());
+		REQUIRE_EQ(r->index(), 1);
+		REQUIRE_EQ(std::get<1>(*r), 42);
+	}
+
+	TEST_CASE("blocks until an element arrives") {
+		channel<int> a{4};
+		exchange_channel<int> b;
+
+		std::jthread producer{[&b]() {
+			std::this_thread::sleep_for(10ms);
+			b.push(7);
+		}};
+
+		auto r = select(a, b);
+		REQUIRE(r.has_value());
+		REQUIRE_EQ(r->index(), 1);
+		REQUIRE_EQ(std::get<1>(*r), 7);
+	}
+
+	TEST_CASE("closed and drained channels are skipped") {
+		channel<int> a{4};
+		channel<int, channel_storage::lock_free_ring> b{4};
+
+		a.push(1);
+		a.close();
+		b.push(2);
+
+		std::vector<int> out;
+		while (auto r = select(a, b)) {
+			out.push_back(std::visit([](int x) { return x; }, *r));
+			if (out.size() == 2) {
+				b.close();
+			}
+		}
+
+		REQUIRE_EQ(out, std::vector<int>{1, 2});
+	}
+
+	TEST_CASE("close wakes up select") {
+		channel<int> a{4};
+		exchange_channel<int> b;
+
+		std::jthread closer{[&]() {
+			std::this_thread::sleep_for(10ms);
+			a.close();
+			b.close();
+		}};
+
+		REQUIRE_FALSE(select(a, b).has_value());
+	}
+
+	TEST_CASE("fan-in from multiple producers") {
+		static constexpr int n_elems = 2000;
+		channel<int> a{8};
+		channel<int, channel_storage::lock_free_ring> b{8};
+
+		std::jthread producer_a{[&a]() {
+			for (int x = 0; x < n_elems; ++x) {
+				a.push(x);
+			}
+			a.close();
+		}};
+		std::jthread producer_b{[&b]() {
+			for (int x = 0; x < n_elems; ++x) {
+				b.push(x);
+			}
+			b.close();
+		}};
+
+		long long sum_a = 0;
+		long long sum_b = 0;
+		int n_a = 0;
+		int n_b = 0;
+		while (auto r = select(a, b)) {
+			if (r->index() == 0) {
+				sum_a += std::get<0>(*r);
+				++n_a;
+			} else {
+				sum_b += std::get<1>(*r);
+				++n_b;
+			}
+		}
+
+		long long const expected_sum = static_cast<long long>(n_elems) * (n_elems - 1) / 2;
+		REQUIRE_EQ(n_a, n_elems);
+		REQUIRE_EQ(n_b, n_elems);
+		REQUIRE_EQ(sum_a, expected_sum);
+		REQUIRE_EQ(sum_b, expected_sum);
+	}
+}
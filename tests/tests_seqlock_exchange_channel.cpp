@@ -0,0 +1,158 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <dice/template-library/seqlock_exchange_channel.hpp>
+#include <dice/template-library/select.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace {
+	/**
+	 * Payload spanning multiple words, used to detect torn reads
+	 */
+	struct estimate {
+		uint64_t version;
+		std::array<uint64_t, 5> copies;
+		uint32_t tail;
+
+		[[nodiscard]] bool consistent() const noexcept {
+			for (auto const x : copies) {
+				if (x != version) {
+					return false;
+				}
+			}
+			return tail == static_cast<uint32_t>(version);
+		}
+	};
+
+	estimate make_estimate(uint64_t version) noexcept {
+		estimate ret{};
+		ret.version = version;
+		ret.copies.fill(version);
+		ret.tail = static_cast<uint32_t>(version);
+		return ret;
+	}
+} // namespace
+
+TEST_SUITE("seqlock_exchange_channel") {
+	using namespace dice::template_library;
+
+	TEST_CASE("sanity check") {
+		seqlock_exchange_channel<int> chan;
+		REQUIRE_FALSE(chan.try_peek().has_value());
+		REQUIRE_FALSE(chan.try_pop().has_value());
+
+		REQUIRE(chan.push(1));
+		REQUIRE(chan.push(2));
+		REQUIRE_EQ(chan.try_peek(), 2);
+		REQUIRE_EQ(chan.try_peek(), 2);
+		REQUIRE_EQ(chan.try_pop(), 2);
+
+		// consumed values can still be peeked, but not popped again
+		REQUIRE_FALSE(chan.try_pop().has_value());
+		REQUIRE_EQ(chan.try_peek(), 2);
+
+		REQUIRE(chan.emplace(3));
+		REQUIRE_EQ(chan.pop(), 3);
+	}
+
+	TEST_CASE("close") {
+		using namespace std::chrono_literals;
+
+		seqlock_exchange_channel<int> chan;
+		REQUIRE_EQ(chan.pop_for(5ms).error(), channel_error::timeout);
+
+		chan.push(1);
+		chan.close();
+		REQUIRE(chan.closed());
+		REQUIRE_FALSE(chan.drained());
+		REQUIRE_FALSE(chan.push(2));
+
+		REQUIRE_EQ(chan.pop_for(5ms), 1);
+		REQUIRE(chan.drained());
+		REQUIRE_FALSE(chan.pop().has_value());
+		REQUIRE_EQ(chan.pop_for(5ms).error(), channel_error::closed);
+	}
+
+	TEST_CASE("close unblocks waiting pop") {
+		seqlock_exchange_channel<int> chan;
+
+		std::optional<int> result{-1};
+		std::jthread consumer{[&]() {
+			result = chan.pop();
+		}};
+
+		chan.close();
+		consumer.join();
+		REQUIRE_FALSE(result.has_value());
+	}
+
+	TEST_CASE("works with select") {
+		seqlock_exchange_channel<int> a;
+		seqlock_exchange_channel<double> b;
+
+		b.push(1.5);
+		auto r = select(a, b);
+		REQUIRE(r.has_value());
+		REQUIRE_EQ(r->index(), 1);
+
+		a.close();
+		b.close();
+		REQUIRE_FALSE(select(a, b).has_value());
+	}
+
+	TEST_CASE("values are never torn and consumed at most once") {
+		constexpr int n_writers = 2;
+		constexpr int n_readers = 3;
+		constexpr uint64_t n_values_per_writer = 20'000;
+
+		seqlock_exchange_channel<estimate> chan;
+		std::atomic<int> n_writers_running = n_writers;
+		std::vector<std::vector<uint64_t>> popped(n_readers);
+
+		{
+			std::vector<std::jthread> threads;
+			for (auto &pop : popped) {
+				threads.emplace_back([&chan, &pop]() {
+					for (auto const &value : chan) {
+						CHECK(value.consistent());
+						pop.push_back(value.version);
+					}
+				});
+			}
+
+			threads.emplace_back([&chan]() {
+				while (!chan.closed()) {
+					if (auto value = chan.try_peek(); value.has_value()) {
+						CHECK(value->consistent());
+					}
+				}
+			});
+
+			for (int w = 0; w < n_writers; ++w) {
+				threads.emplace_back([&chan, &n_writers_running, w]() {
+					for (uint64_t ix = 1; ix <= n_values_per_writer; ++ix) {
+						chan.push(make_estimate(w * n_values_per_writer + ix));
+					}
+
+					if (n_writers_running.fetch_sub(1) == 1) {
+						chan.close();
+					}
+				});
+			}
+		}
+
+		std::vector<uint64_t> all;
+		for (auto const &pop : popped) {
+			all.insert(all.end(), pop.begin(), pop.end());
+		}
+		std::ranges::sort(all);
+		REQUIRE(std::ranges::adjacent_find(all) == all.end());
+	}
+}
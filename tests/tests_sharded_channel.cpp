@@ -0,0 +1,142 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <dice/template-library/sharded_channel.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_SUITE("sharded_channel") {
+	using namespace dice::template_library;
+
+	TEST_CASE("is range") {
+		static_assert(std::input_iterator<sharded_channel<int>::iterator>);
+		static_assert(std::ranges::input_range<sharded_channel<int>>);
+		static_assert(std::ranges::input_range<sharded_channel<int>::consumer_handle>);
+	}
+
+	TEST_CASE("sanity check") {
+		sharded_channel<std::string> chan{2, 2};
+		REQUIRE_EQ(chan.n_shards(), 2);
+		REQUIRE_FALSE(chan.closed());
+		REQUIRE_EQ(chan.try_pop(), std::nullopt);
+
+		std::string const s{"a"};
+		chan.push(s);
+		chan.push(std::string{"b"});
+		chan.emplace("c");
+		chan.emplace_at(1, "d");
+
+		// no capacity left in any shard
+		REQUIRE_FALSE(chan.try_push(s));
+		REQUIRE_FALSE(chan.try_push(std::string{"e"}));
+		REQUIRE_FALSE(chan.try_emplace("e"));
+		REQUIRE_FALSE(chan.try_emplace_at(0, "e"));
+
+		chan.close();
+		REQUIRE(chan.closed());
+
+		std::vector<std::string> out;
+		while (auto x = chan.pop(0)) {
+			out.push_back(std::move(*x));
+		}
+		REQUIRE_EQ(chan.try_pop(), std::nullopt);
+
+		std::ranges::sort(out);
+		REQUIRE_EQ(out, std::vector<std::string>{"a", "b", "c", "d"});
+	}
+
+	TEST_CASE("home shard is preferred, other shards are stolen from") {
+		sharded_channel<int> chan{3, 4};
+
+		REQUIRE(chan.try_emplace_at(0, 0));
+		REQUIRE(chan.try_emplace_at(1, 1));
+		REQUIRE(chan.try_emplace_at(2, 2));
+		REQUIRE(chan.try_emplace_at(5, 3)); // hint is taken modulo n_shards
+
+		REQUIRE_EQ(chan.try_pop(2), 2);
+		REQUIRE_EQ(chan.try_pop(2), 3);
+		REQUIRE_EQ(chan.try_pop(2), 0); // stolen from shard 0
+		REQUIRE_EQ(chan.try_pop(1), 1);
+		REQUIRE_EQ(chan.try_pop(1), std::nullopt);
+	}
+
+	TEST_CASE("full shards spill over") {
+		sharded_channel<int> chan{2, 1};
+		REQUIRE(chan.try_emplace_at(0, 0));
+		REQUIRE(chan.try_emplace_at(0, 1)); // shard 0 is full, lands in shard 1
+		REQUIRE_FALSE(chan.try_emplace_at(0, 2));
+
+		REQUIRE_EQ(chan.try_pop(1), 1);
+		REQUIRE_EQ(chan.try_pop(1), 0);
+	}
+
+	TEST_CASE("closed push") {
+		sharded_channel<std::string> chan{4, 8};
+		chan.close();
+
+		REQUIRE_FALSE(chan.push(std::string{"a"}));
+		REQUIRE_FALSE(chan.try_push(std::string{"a"}));
+		REQUIRE_FALSE(chan.emplace("a"));
+		REQUIRE_FALSE(chan.emplace_at(3, "a"));
+		REQUIRE_EQ(chan.pop(), std::nullopt);
+	}
+
+	TEST_CASE("unconsumed elements are destroyed") {
+		auto const value = std::make_shared<int>(5);
+
+		{
+			sharded_channel<std::shared_ptr<int>> chan{2, 4};
+			chan.push(value);
+			chan.push(value);
+			chan.push(value);
+			REQUIRE_EQ(value.use_count(), 4);
+		}
+
+		REQUIRE_EQ(value.use_count(), 1);
+	}
+
+	TEST_CASE("multiple producers and consumers") {
+		static constexpr size_t n_threads = 4;
+		static constexpr int n_elems = 20'000;
+		sharded_channel<int> chan{n_threads, 8};
+
+		std::atomic<size_t> n_producers_running = n_threads;
+		std::vector<std::vector<int>> received(n_threads);
+
+		{
+			std::vector<std::jthread> threads;
+			for (size_t ix = 0; ix < n_threads; ++ix) {
+				threads.emplace_back([&chan, &n_producers_running, ix]() {
+					for (int x = static_cast<int>(ix); x < n_elems; x += static_cast<int>(n_threads)) {
+						REQUIRE(chan.push(x));
+					}
+
+					if (n_producers_running.fetch_sub(1) == 1) {
+						chan.close();
+					}
+				});
+
+				threads.emplace_back([&chan, &received, ix]() {
+					for (int const x : chan.consumer(ix)) {
+						received[ix].push_back(x);
+					}
+				});
+			}
+		}
+
+		std::vector<int> all;
+		for (auto const &r : received) {
+			all.insert(all.end(), r.begin(), r.end());
+		}
+		std::ranges::sort(all);
+		REQUIRE(std::ranges::equal(all, std::views::iota(0, n_elems)));
+	}
+}
@@ -0,0 +1,221 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <dice/template-library/slab_pool.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+TEST_SUITE("slab_pool") {
+	using namespace dice::template_library;
+
+	static_assert(!std::is_copy_constructible_v<slab_pool>);
+	static_assert(!std::is_move_constructible_v<slab_pool>);
+
+	TEST_CASE("basic") {
+		slab_pool pool{24};
+		REQUIRE_EQ(pool.chunk_size(), 24);
+		REQUIRE(std::has_single_bit(pool.slab_size()));
+		REQUIRE_EQ(pool.reserved_bytes(), 0);
+
+		auto *a = pool.allocate();
+		auto *b = pool.allocate();
+		REQUIRE_NE(a, b);
+		REQUIRE_EQ(reinterpret_cast<uintptr_t>(a) % alignof(void *), 0);
+		REQUIRE_EQ(pool.n_live(), 2);
+		REQUIRE_EQ(pool.reserved_bytes(), pool.slab_size());
+
+		// freed chunks are reused first
+		pool.deallocate(a);
+		REQUIRE_EQ(pool.allocate(), a);
+
+		pool.deallocate(a);
+		pool.deallocate(b);
+		REQUIRE_EQ(pool.n_live(), 0);
+	}
+
+	TEST_CASE("chunk size") {
+		REQUIRE_EQ(slab_pool{1}.chunk_size(), sizeof(void *));
+		REQUIRE_EQ(slab_pool{9}.chunk_size(), 2 * sizeof(void *));
+
+		// slabs grow to hold multiple large chunks
+		slab_pool large{100'000};
+		REQUIRE_GE(large.slab_size(), 8 * 100'000);
+		auto *ptr = large.allocate();
+		std::fill_n(static_cast<std::byte *>(ptr), 100'000, std::byte{1});
+		large.deallocate(ptr);
+	}
+
+	TEST_CASE("slab size") {
+		// small pools only reserve a page
+		slab_pool small{8};
+		REQUIRE_EQ(small.slab_size(), 4096);
+		auto *ptr = small.allocate();
+		REQUIRE_EQ(small.reserved_bytes(), 4096);
+		small.deallocate(ptr);
+
+		// slabs are large enough for initial_block_chunks chunks
+		slab_pool sized{64, pool_config{.initial_block_chunks = 1000}};
+		REQUIRE_EQ(sized.slab_size(), 64 * 1024);
+
+		// but not larger than max_block_bytes
+		slab_pool capped{64, pool_config{.initial_block_chunks = 1000, .max_block_bytes = 16 * 1024}};
+		REQUIRE_EQ(capped.slab_size(), 16 * 1024);
+	}
+
+	TEST_CASE("chunks are inside their slab") {
+		slab_pool pool{64};
+
+		std::vector<std::byte *> ptrs;
+		for (size_t ix = 0; ix < 10'000; ++ix) {
+			ptrs.push_back(static_cast<std::byte *>(pool.allocate()));
+		}
+
+		auto const mask = ~(static_cast<uintptr_t>(pool.slab_size()) - 1);
+		for (auto *ptr : ptrs) {
+			REQUIRE_EQ(reinterpret_cast<uintptr_t>(ptr) & mask, reinterpret_cast<uintptr_t>(ptr + pool.chunk_size() - 1) & mask);
+		}
+
+		std::ranges::sort(ptrs);
+		REQUIRE(std::ranges::adjacent_find(ptrs, [&](auto *lhs, auto *rhs) { return rhs - lhs < static_cast<std::ptrdiff_t>(pool.chunk_size()); }) == ptrs.end());
+
+		for (auto *ptr : ptrs) {
+			pool.deallocate(ptr);
+		}
+	}
+
+	TEST_CASE("release_unused is precise") {
+		slab_pool pool{64, pool_config{.initial_block_chunks = 1, .growth_factor = 1.0}};
+
+		std::vector<void *> ptrs;
+		for (size_t ix = 0; ix < 10'000; ++ix) {
+			ptrs.push_back(pool.allocate());
+		}
+		auto const n_slabs = pool.reserved_bytes() / pool.slab_size();
+		REQUIRE_GT(n_slabs, 2);
+
+		// keep one chunk of the first slab alive
+		auto const mask = ~(static_cast<uintptr_t>(pool.slab_size()) - 1);
+		auto *keep = ptrs.front();
+		for (auto *ptr : ptrs) {
+			if (ptr != keep) {
+				pool.deallocate(ptr);
+			}
+		}
+
+		REQUIRE(pool.release_unused());
+		REQUIRE_EQ(pool.reserved_bytes(), pool.slab_size());
+		REQUIRE_EQ(pool.n_live(), 1);
+
+		auto *other = pool.allocate();
+		REQUIRE_EQ(reinterpret_cast<uintptr_t>(other) & mask, reinterpret_cast<uintptr_t>(keep) & mask);
+		pool.deallocate(other);
+
+		pool.deallocate(keep);
+		REQUIRE(pool.release_unused());
+		REQUIRE_EQ(pool.reserved_bytes(), 0);
+		REQUIRE_FALSE(pool.release_unused());
+	}
+
+	TEST_CASE("max_free_chunks") {
+		slab_pool pool{64, pool_config{.max_free_chunks = 0}};
+
+		for (size_t round = 0; round < 3; ++round) {
+			std::vector<void *> ptrs;
+			for (size_t ix = 0; ix < 10'000; ++ix) {
+				ptrs.push_back(pool.allocate());
+			}
+			for (auto *ptr : ptrs) {
+				pool.deallocate(ptr);
+			}
+			// at most one empty slab is kept (hysteresis)
+			REQUIRE_LE(pool.reserved_bytes(), pool.slab_size());
+		}
+
+		REQUIRE(pool.release_unused());
+		REQUIRE_EQ(pool.reserved_bytes(), 0);
+	}
+
+	TEST_CASE("max_free_chunks does not churn slabs") {
+		// more chunks per slab than max_free_chunks
+		slab_pool pool{64, pool_config{.initial_block_chunks = 4096, .max_free_chunks = 1000}};
+		REQUIRE_GT(pool.slab_size() / pool.chunk_size(), 1000);
+
+		for (size_t round = 0; round < 200'000; ++round) {
+			std::array<void *, 4> ptrs;
+			for (auto &ptr : ptrs) {
+				ptr = pool.allocate();
+			}
+			for (auto *ptr : ptrs) {
+				pool.deallocate(ptr);
+			}
+
+			// the empty slab is kept instead of being freed and re-allocated in the next round
+			REQUIRE_EQ(pool.reserved_bytes(), pool.slab_size());
+		}
+
+		// larger peaks are still trimmed
+		std::vector<void *> ptrs;
+		for (size_t ix = 0; ix < 100'000; ++ix) {
+			ptrs.push_back(pool.allocate());
+		}
+		for (auto *ptr : ptrs) {
+			pool.deallocate(ptr);
+		}
+		REQUIRE_LE(pool.n_free_chunks(), 1000 + pool.slab_size() / pool.chunk_size());
+	}
+
+	TEST_CASE("purge_memory") {
+		slab_pool pool{16};
+		for (size_t ix = 0; ix < 10'000; ++ix) {
+			[[maybe_unused]] auto *ptr = pool.allocate();
+		}
+
+		pool.purge_memory();
+		REQUIRE_EQ(pool.reserved_bytes(), 0);
+		REQUIRE_EQ(pool.n_live(), 0);
+
+		pool.deallocate(pool.allocate());
+	}
+
+	TEST_CASE("huge pages") {
+		slab_pool pool{64, pool_config{.huge_pages = true}};
+		REQUIRE_EQ(pool.slab_size(), size_t{2} * 1024 * 1024);
+
+		auto *ptr = pool.allocate();
+		REQUIRE_EQ(pool.reserved_bytes(), pool.slab_size());
+		pool.deallocate(ptr);
+	}
+
+	TEST_CASE("random allocations and deallocations") {
+		slab_pool pool{40, pool_config{.max_free_chunks = 1000}};
+		std::mt19937_64 rng{42};
+
+		std::vector<uint64_t *> live;
+		for (size_t op = 0; op < 200'000; ++op) {
+			if (live.empty() || rng() % 3 != 0) {
+				auto *ptr = static_cast<uint64_t *>(pool.allocate());
+				std::fill_n(ptr, 5, op);
+				live.push_back(ptr);
+			} else {
+				auto const ix = rng() % live.size();
+				std::swap(live[ix], live.back());
+				CHECK(std::all_of(live.back(), live.back() + 5, [&](auto x) { return x == live.back()[0]; }));
+				pool.deallocate(live.back());
+				live.pop_back();
+			}
+		}
+
+		REQUIRE_EQ(pool.n_live(), live.size());
+		for (auto *ptr : live) {
+			pool.deallocate(ptr);
+		}
+		REQUIRE_LE(pool.n_free_chunks(), 1000);
+	}
+}
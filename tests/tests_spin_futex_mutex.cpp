@@ -0,0 +1,88 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <dice/template-library/channel.hpp>
+#include <dice/template-library/mutex.hpp>
+#include <dice/template-library/spin_futex_mutex.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+TEST_SUITE("spin_futex_mutex") {
+	using namespace dice::template_library;
+
+	TEST_CASE("lock and try_lock") {
+		spin_futex_mutex mut;
+		REQUIRE(mut.try_lock());
+		REQUIRE_FALSE(mut.try_lock());
+		mut.unlock();
+
+		mut.lock();
+		REQUIRE_FALSE(mut.try_lock());
+		mut.unlock();
+
+		std::lock_guard lock{mut};
+		REQUIRE_FALSE(mut.try_lock());
+	}
+
+	TEST_CASE("blocked threads are woken up") {
+		basic_spin_futex_mutex<0> mut; // never spins
+		mut.lock();
+
+		std::atomic<bool> acquired = false;
+		std::jthread waiter{[&]() {
+			std::lock_guard lock{mut};
+			acquired = true;
+		}};
+
+		std::this_thread::sleep_for(std::chrono::milliseconds{10});
+		REQUIRE_FALSE(acquired.load());
+		mut.unlock();
+		waiter.join();
+		REQUIRE(acquired.load());
+	}
+
+	TEST_CASE_TEMPLATE("mutual exclusion", M, spin_futex_mutex, basic_spin_futex_mutex<0>) {
+		constexpr int n_threads = 4;
+		constexpr int n_iterations = 50'000;
+
+		mutex<long, M> counter{0};
+		{
+			std::vector<std::jthread> threads;
+			for (int ix = 0; ix < n_threads; ++ix) {
+				threads.emplace_back([&counter]() {
+					for (int it = 0; it < n_iterations; ++it) {
+						++*counter.lock();
+					}
+				});
+			}
+		}
+
+		REQUIRE_EQ(*counter.lock(), n_threads * n_iterations);
+		REQUIRE(counter.try_lock().has_value());
+	}
+
+	TEST_CASE("usable as channel mutex") {
+		constexpr int n_elems = 10'000;
+
+		channel<int, channel_storage::locked_queue, channel_instrumentation::disabled, adaptive_wait_policy<>, spin_futex_mutex> chan{8};
+		std::jthread producer{[&chan]() {
+			for (int x = 0; x < n_elems; ++x) {
+				chan.push(x);
+			}
+			chan.close();
+		}};
+
+		long sum = 0;
+		for (int const x : chan) {
+			sum += x;
+		}
+		REQUIRE_EQ(sum, static_cast<long>(n_elems) * (n_elems - 1) / 2);
+
+		using namespace std::chrono_literals;
+		REQUIRE_EQ(chan.pop_for(1ms).error(), channel_error::closed);
+	}
+}
@@ -0,0 +1,104 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <dice/template-library/spsc_channel.hpp>
+
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_SUITE("spsc_channel") {
+	using namespace dice::template_library;
+
+	TEST_CASE("is range") {
+		static_assert(std::input_iterator<spsc_channel<int>::iterator>);
+		static_assert(std::ranges::range<spsc_channel<int>>);
+		static_assert(std::ranges::input_range<spsc_channel<int>>);
+	}
+
+	TEST_CASE("rejects capacity of zero") {
+		REQUIRE_THROWS_AS(spsc_channel<int>{0}, std::invalid_argument);
+	}
+
+	TEST_CASE("sanity check") {
+		spsc_channel<std::string> chan{3};
+		REQUIRE_FALSE(chan.closed());
+		REQUIRE_EQ(chan.try_pop(), std::nullopt);
+
+		std::string const s{"a"};
+		chan.push(s);
+
+		chan.push(std::string{"b"});
+		chan.emplace("c");
+
+		// no capacity left
+		REQUIRE_FALSE(chan.try_push(s));
+		REQUIRE_FALSE(chan.try_push(std::string{"b"}));
+		REQUIRE_FALSE(chan.try_emplace("c"));
+
+		chan.close();
+		REQUIRE(chan.closed());
+
+		REQUIRE_EQ(chan.pop(), "a");
+		REQUIRE_EQ(chan.pop(), "b");
+		REQUIRE_EQ(chan.pop(), "c");
+		REQUIRE_EQ(chan.pop(), std::nullopt);
+		REQUIRE_EQ(chan.try_pop(), std::nullopt);
+	}
+
+	TEST_CASE("wraps around") {
+		spsc_channel<int> chan{2};
+		for (int x = 0; x < 10; ++x) {
+			REQUIRE(chan.try_push(x));
+			REQUIRE_EQ(chan.try_pop(), x);
+		}
+		REQUIRE_EQ(chan.try_pop(), std::nullopt);
+	}
+
+	TEST_CASE("closed push") {
+		spsc_channel<std::string> chan{8};
+		chan.close();
+
+		REQUIRE_FALSE(chan.push(std::string{"a"}));
+		REQUIRE_FALSE(chan.try_push(std::string{"a"}));
+		REQUIRE_FALSE(chan.emplace("a"));
+		REQUIRE_EQ(chan.pop(), std::nullopt);
+	}
+
+	TEST_CASE("unconsumed elements are destroyed") {
+		auto const value = std::make_shared<int>(5);
+
+		{
+			spsc_channel<std::shared_ptr<int>> chan{4};
+			chan.push(value);
+			chan.push(value);
+			REQUIRE_EQ(value.use_count(), 3);
+		}
+
+		REQUIRE_EQ(value.use_count(), 1);
+	}
+
+	TEST_CASE("producer and consumer thread") {
+		static constexpr int n_elems = 100'000;
+		spsc_channel<int> chan{16};
+
+		std::jthread producer{[&chan]() {
+			for (int x = 0; x < n_elems; ++x) {
+				chan.push(x);
+			}
+			chan.close(); // don't forget to close
+		}};
+
+		std::vector<int> received;
+		for (int const x : chan) {
+			received.push_back(x);
+		}
+
+		REQUIRE(std::ranges::equal(received, std::views::iota(0, n_elems)));
+	}
+}
@@ -0,0 +1,100 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <dice/template-library/shared_mutex.hpp>
+#include <dice/template-library/striped_shared_mutex.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+TEST_SUITE("striped_shared_mutex") {
+	using namespace dice::template_library;
+
+	TEST_CASE("exclusive and shared locking") {
+		striped_shared_mutex<> mut;
+
+		mut.lock();
+		REQUIRE_FALSE(mut.try_lock());
+		REQUIRE_FALSE(mut.try_lock_shared());
+		mut.unlock();
+
+		mut.lock_shared();
+		REQUIRE(mut.try_lock_shared());
+		REQUIRE_FALSE(mut.try_lock());
+		mut.unlock_shared();
+		mut.unlock_shared();
+
+		REQUIRE(mut.try_lock());
+		mut.unlock();
+	}
+
+	TEST_CASE("readers on other threads block writers") {
+		striped_shared_mutex<4> mut;
+		std::atomic<bool> reader_locked = false;
+		std::atomic<bool> release_reader = false;
+
+		std::jthread reader{[&]() {
+			std::shared_lock lock{mut};
+			reader_locked = true;
+			while (!release_reader) {
+				std::this_thread::yield();
+			}
+		}};
+
+		while (!reader_locked) {
+			std::this_thread::yield();
+		}
+		REQUIRE_FALSE(mut.try_lock());
+
+		release_reader = true;
+		reader.join();
+		REQUIRE(mut.try_lock());
+		mut.unlock();
+	}
+
+	TEST_CASE("usable as shared_mutex parameter") {
+		shared_mutex<std::vector<int>, striped_shared_mutex<>> mut{std::vector<int>{1, 2, 3}};
+		mut.lock()->push_back(4);
+		REQUIRE_EQ(mut.lock_shared()->size(), 4);
+
+		auto guard = mut.try_lock_shared();
+		REQUIRE(guard.has_value());
+		REQUIRE_FALSE(mut.try_lock().has_value());
+	}
+
+	TEST_CASE("concurrent readers and writers") {
+		constexpr int n_readers = 6;
+		constexpr int n_writers = 2;
+		constexpr int n_iterations = 20'000;
+
+		// fewer stripes than threads, so that stripes are shared
+		shared_mutex<std::vector<int>, striped_shared_mutex<4>> mut{std::vector<int>(2, 0)};
+
+		{
+			std::vector<std::jthread> threads;
+			for (int ix = 0; ix < n_writers; ++ix) {
+				threads.emplace_back([&mut]() {
+					for (int it = 0; it < n_iterations; ++it) {
+						auto guard = mut.lock();
+						++(*guard)[0];
+						++(*guard)[1];
+					}
+				});
+			}
+
+			for (int ix = 0; ix < n_readers; ++ix) {
+				threads.emplace_back([&mut]() {
+					for (int it = 0; it < n_iterations; ++it) {
+						auto guard = mut.lock_shared();
+						CHECK_EQ((*guard)[0], (*guard)[1]);
+					}
+				});
+			}
+		}
+
+		REQUIRE_EQ((*mut.lock_shared())[0], n_writers * n_iterations);
+	}
+}
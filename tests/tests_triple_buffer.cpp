@@ -0,0 +1,106 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <dice/template-library/triple_buffer.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_SUITE("triple_buffer") {
+	using namespace dice::template_library;
+
+	TEST_CASE("sanity check") {
+		triple_buffer<int> buf{42};
+		REQUIRE_FALSE(buf.has_update());
+		REQUIRE_FALSE(buf.update());
+		REQUIRE_EQ(buf.front(), 42);
+
+		buf.back() = 1;
+		buf.publish();
+		REQUIRE(buf.has_update());
+		REQUIRE_EQ(buf.front(), 42);
+		REQUIRE(buf.update());
+		REQUIRE_FALSE(buf.has_update());
+		REQUIRE_EQ(buf.front(), 1);
+		REQUIRE_FALSE(buf.update());
+		REQUIRE_EQ(buf.front(), 1);
+	}
+
+	TEST_CASE("latest value wins") {
+		triple_buffer<int> buf;
+		buf.push(1);
+		buf.push(2);
+		buf.write([](int &x) { x = 3; });
+		REQUIRE_EQ(buf.read(), 3);
+		REQUIRE_EQ(buf.read(), 3);
+
+		buf.push(4);
+		REQUIRE_EQ(buf.read(), 4);
+	}
+
+	TEST_CASE("buffers are reused") {
+		triple_buffer<std::vector<int>> buf;
+		std::vector<int const *> seen;
+
+		for (int ix = 0; ix < 9; ++ix) {
+			auto &back = buf.back();
+			back.assign(1000, ix);
+			seen.push_back(back.data());
+			buf.publish();
+
+			auto const &front = buf.read();
+			REQUIRE_EQ(front.size(), 1000);
+			REQUIRE_EQ(front.front(), ix);
+		}
+
+		// after the first round, the producer only ever writes into the allocations of the three buffers
+		for (size_t ix = 3; ix < seen.size(); ++ix) {
+			REQUIRE((seen[ix] == seen[0] || seen[ix] == seen[1] || seen[ix] == seen[2]));
+		}
+	}
+
+	TEST_CASE("concurrent producer and consumer") {
+		constexpr int n_values = 100'000;
+
+		struct snapshot {
+			int version = 0;
+			std::vector<int> data = std::vector<int>(64, 0);
+		};
+
+		triple_buffer<snapshot> buf;
+		std::atomic<bool> done = false;
+
+		std::jthread producer{[&]() {
+			for (int version = 1; version <= n_values; ++version) {
+				buf.write([version](snapshot &snap) {
+					snap.version = version;
+					std::ranges::fill(snap.data, version);
+				});
+			}
+			done = true;
+		}};
+
+		int last_version = 0;
+		while (true) {
+			auto const finished = done.load();
+			auto const &snap = buf.read();
+
+			// a snapshot is never torn and versions never go backwards
+			REQUIRE_GE(snap.version, last_version);
+			for (int const x : snap.data) {
+				REQUIRE_EQ(x, snap.version);
+			}
+			last_version = snap.version;
+
+			if (finished) {
+				break;
+			}
+		}
+
+		REQUIRE_EQ(last_version, n_values);
+	}
+}
@@ -0,0 +1,235 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <dice/template-library/shared_mutex.hpp>
+#include <dice/template-library/upgrade_mutex.hpp>
+
+#include <atomic>
+#include <map>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+TEST_SUITE("upgrade_mutex") {
+	using namespace dice::template_library;
+
+	static_assert(upgrade_lockable<upgrade_mutex>);
+	static_assert(downgrade_lockable<upgrade_mutex>);
+	static_assert(!upgrade_lockable<std::shared_mutex>);
+	static_assert(!downgrade_lockable<std::shared_mutex>);
+
+	static_assert(!std::is_copy_constructible_v<shared_mutex_upgradable_guard<int, upgrade_mutex>>);
+	static_assert(std::is_nothrow_move_constructible_v<shared_mutex_upgradable_guard<int, upgrade_mutex>>);
+
+	template<typename M>
+	concept can_lock_upgradable = requires (M &mut) {
+		mut.lock_upgradable();
+	};
+
+	template<typename G>
+	concept can_downgrade = requires (G &&guard) {
+		std::move(guard).downgrade();
+	};
+
+	static_assert(can_lock_upgradable<shared_mutex<int, upgrade_mutex>>);
+	static_assert(!can_lock_upgradable<shared_mutex<int>>);
+	static_assert(can_downgrade<shared_mutex_guard<int, upgrade_mutex>>);
+	static_assert(!can_downgrade<shared_mutex_guard<int const, upgrade_mutex>>);
+	static_assert(!can_downgrade<shared_mutex_guard<int>>);
+
+	TEST_CASE("basic locking") {
+		upgrade_mutex mut;
+
+		mut.lock();
+		REQUIRE_FALSE(mut.try_lock());
+		REQUIRE_FALSE(mut.try_lock_shared());
+		REQUIRE_FALSE(mut.try_lock_upgrade());
+		mut.unlock();
+
+		mut.lock_shared();
+		REQUIRE(mut.try_lock_shared());
+		REQUIRE_FALSE(mut.try_lock());
+		mut.unlock_shared();
+		mut.unlock_shared();
+
+		REQUIRE(mut.try_lock());
+		mut.unlock();
+	}
+
+	TEST_CASE("upgradable ownership coexists with shared ownership") {
+		upgrade_mutex mut;
+
+		mut.lock_upgrade();
+		REQUIRE(mut.try_lock_shared());
+		REQUIRE_FALSE(mut.try_lock_upgrade());
+		REQUIRE_FALSE(mut.try_lock());
+		mut.unlock_shared();
+
+		mut.unlock_upgrade_and_lock();
+		REQUIRE_FALSE(mut.try_lock_shared());
+		REQUIRE_FALSE(mut.try_lock_upgrade());
+
+		mut.unlock_and_lock_upgrade();
+		REQUIRE(mut.try_lock_shared());
+		mut.unlock_shared();
+
+		mut.unlock_upgrade();
+		REQUIRE(mut.try_lock());
+		mut.unlock();
+	}
+
+	TEST_CASE("upgrade waits for readers") {
+		upgrade_mutex mut;
+		std::atomic<bool> upgraded = false;
+
+		mut.lock_shared();
+
+		std::thread upgrader{[&]() {
+			mut.lock_upgrade();
+			mut.unlock_upgrade_and_lock();
+			upgraded = true;
+			mut.unlock();
+		}};
+
+		std::this_thread::sleep_for(std::chrono::milliseconds{50});
+		REQUIRE_FALSE(upgraded.load());
+
+		mut.unlock_shared();
+		upgrader.join();
+		REQUIRE(upgraded.load());
+	}
+
+	TEST_CASE("shared_mutex lock_upgradable") {
+		shared_mutex<int, upgrade_mutex> mut{5};
+
+		{
+			auto ug = mut.lock_upgradable();
+			REQUIRE_EQ(*ug, 5);
+
+			// readers can still enter, but no other upgrader or writer
+			REQUIRE(mut.try_lock_shared().has_value());
+			REQUIRE_FALSE(mut.try_lock_upgradable().has_value());
+			REQUIRE_FALSE(mut.try_lock().has_value());
+
+			auto g = std::move(ug).upgrade();
+			*g = 6;
+			REQUIRE_FALSE(mut.try_lock_shared().has_value());
+		}
+
+		REQUIRE_EQ(*mut.lock_shared(), 6);
+
+		auto ug = mut.try_lock_upgradable();
+		REQUIRE(ug.has_value());
+		REQUIRE_EQ(**ug, 6);
+	}
+
+	TEST_CASE("shared_mutex downgrade") {
+		shared_mutex<std::string, upgrade_mutex> mut{"hello"};
+
+		auto g = mut.lock();
+		*g += " world";
+
+		auto sg = std::move(g).downgrade();
+		static_assert(std::is_same_v<decltype(sg), shared_mutex_guard<std::string const, upgrade_mutex>>);
+		REQUIRE_EQ(*sg, "hello world");
+
+		REQUIRE(mut.try_lock_shared().has_value());
+		REQUIRE_FALSE(mut.try_lock().has_value());
+	}
+
+	TEST_CASE("moved from upgradable guard does not unlock") {
+		shared_mutex<int, upgrade_mutex> mut{};
+
+		auto a = mut.lock_upgradable();
+		auto b = std::move(a);
+		REQUIRE_FALSE(mut.try_lock_upgradable().has_value());
+
+		{
+			[[maybe_unused]] auto c = std::move(b);
+		}
+		REQUIRE(mut.try_lock_upgradable().has_value());
+	}
+
+	TEST_CASE("concurrent cache fill") {
+		shared_mutex<std::map<int, int>, upgrade_mutex> cache;
+		std::atomic<int> n_computed = 0;
+
+		auto get = [&](int key) {
+			{
+				auto g = cache.lock_shared();
+				if (auto it = g->find(key); it != g->end()) {
+					return it->second;
+				}
+			}
+
+			auto ug = cache.lock_upgradable();
+			if (auto it = ug->find(key); it != ug->end()) {
+				return it->second;
+			}
+
+			auto g = std::move(ug).upgrade();
+			n_computed.fetch_add(1);
+			auto const value = key * key;
+			g->emplace(key, value);
+			return value;
+		};
+
+		std::vector<std::thread> threads;
+		for (int t = 0; t < 4; ++t) {
+			threads.emplace_back([&]() {
+				for (int ix = 0; ix < 1000; ++ix) {
+					auto const key = ix % 50;
+					CHECK_EQ(get(key), key * key);
+				}
+			});
+		}
+
+		for (auto &t : threads) {
+			t.join();
+		}
+
+		// every value is computed exactly once
+		REQUIRE_EQ(n_computed.load(), 50);
+		REQUIRE_EQ(cache.lock_shared()->size(), 50);
+	}
+
+	TEST_CASE("concurrent readers, writers, upgraders and downgraders") {
+		shared_mutex<int, upgrade_mutex> mut{0};
+		std::vector<std::thread> threads;
+
+		for (int t = 0; t < 2; ++t) {
+			threads.emplace_back([&]() {
+				for (int ix = 0; ix < 500; ++ix) {
+					auto g = mut.lock();
+					++*g;
+					auto sg = std::move(g).downgrade();
+					CHECK_GT(*sg, 0);
+				}
+			});
+
+			threads.emplace_back([&]() {
+				for (int ix = 0; ix < 500; ++ix) {
+					auto ug = mut.lock_upgradable();
+					auto const prev = *ug;
+					auto g = std::move(ug).upgrade();
+					CHECK_EQ(*g, prev);
+					++*g;
+				}
+			});
+
+			threads.emplace_back([&]() {
+				for (int ix = 0; ix < 1000; ++ix) {
+					CHECK_GE(*mut.lock_shared(), 0);
+				}
+			});
+		}
+
+		for (auto &t : threads) {
+			t.join();
+		}
+
+		REQUIRE_EQ(*mut.lock_shared(), 2000);
+	}
+}
@@ -0,0 +1,204 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <dice/template-library/vec_deque.hpp>
+
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+TEST_SUITE("vec_deque") {
+	using namespace dice::template_library;
+
+	static_assert(std::random_access_iterator<vec_deque<int>::iterator>);
+	static_assert(std::random_access_iterator<vec_deque<int>::const_iterator>);
+	static_assert(std::ranges::random_access_range<vec_deque<int>>);
+	static_assert(std::ranges::sized_range<vec_deque<int>>);
+	static_assert(std::is_convertible_v<vec_deque<int>::iterator, vec_deque<int>::const_iterator>);
+
+	template<typename T>
+	std::vector<T> to_vector(vec_deque<T> const &dq) {
+		return std::vector<T>(dq.begin(), dq.end());
+	}
+
+	TEST_CASE("default ctor") {
+		vec_deque<int> dq;
+		REQUIRE(dq.empty());
+		REQUIRE_EQ(dq.size(), 0);
+		REQUIRE_EQ(dq.capacity(), 0);
+		REQUIRE_EQ(dq.begin(), dq.end());
+
+		auto [first, second] = dq.as_slices();
+		REQUIRE(first.empty());
+		REQUIRE(second.empty());
+	}
+
+	TEST_CASE("push and pop at both ends") {
+		vec_deque<int> dq;
+		dq.push_back(2);
+		dq.push_back(3);
+		dq.push_front(1);
+		dq.emplace_front(0);
+		dq.emplace_back(4);
+
+		REQUIRE_EQ(dq.size(), 5);
+		REQUIRE_EQ(dq.front(), 0);
+		REQUIRE_EQ(dq.back(), 4);
+		REQUIRE_EQ(to_vector(dq), std::vector<int>{0, 1, 2, 3, 4});
+
+		dq.pop_front();
+		dq.pop_back();
+		REQUIRE_EQ(to_vector(dq), std::vector<int>{1, 2, 3});
+		REQUIRE_EQ(dq[0], 1);
+		REQUIRE_EQ(dq.at(2), 3);
+		REQUIRE_THROWS_AS((void) dq.at(3), std::out_of_range);
+	}
+
+	TEST_CASE("fifo usage does not allocate after reserve") {
+		vec_deque<int> dq;
+		dq.reserve(8);
+		REQUIRE_EQ(dq.capacity(), 8);
+
+		int next_in = 0;
+		int next_out = 0;
+		for (int round = 0; round < 100; ++round) {
+			while (dq.size() < dq.capacity()) {
+				dq.push_back(next_in++);
+			}
+
+			for (int ix = 0; ix < 5; ++ix) {
+				REQUIRE_EQ(dq.front(), next_out++);
+				dq.pop_front();
+			}
+		}
+
+		REQUIRE_EQ(dq.capacity(), 8);
+	}
+
+	TEST_CASE("as_slices") {
+		vec_deque<int> dq;
+		dq.reserve(4);
+		dq.push_back(1);
+		dq.push_back(2);
+		dq.push_back(3);
+		dq.pop_front();
+		dq.pop_front();
+		dq.push_back(4);
+		dq.push_back(5); // wraps around
+
+		auto [first, second] = dq.as_slices();
+		REQUIRE_EQ(first.size() + second.size(), dq.size());
+		REQUIRE_EQ(std::vector<int>(first.begin(), first.end()), std::vector<int>{3, 4});
+		REQUIRE_EQ(std::vector<int>(second.begin(), second.end()), std::vector<int>{5});
+	}
+
+	TEST_CASE("growth keeps order when wrapped") {
+		vec_deque<std::string> dq;
+		dq.reserve(4);
+		dq.push_back("c");
+		dq.push_back("d");
+		dq.push_front("b");
+		dq.push_front("a");
+		REQUIRE_EQ(dq.capacity(), 4);
+
+		dq.push_back("e"); // needs to grow
+		REQUIRE_GE(dq.capacity(), 5);
+		REQUIRE_EQ(to_vector(dq), std::vector<std::string>{"a", "b", "c", "d", "e"});
+	}
+
+	TEST_CASE("push a reference to an own element while growing") {
+		vec_deque<std::string> dq{"a", "b", "c", "d"};
+		dq.shrink_to_fit();
+		REQUIRE_EQ(dq.capacity(), dq.size());
+
+		dq.push_back(dq.front());
+		dq.push_front(dq.back());
+		REQUIRE_EQ(to_vector(dq), std::vector<std::string>{"a", "a", "b", "c", "d", "a"});
+	}
+
+	TEST_CASE("shrink_to_fit") {
+		vec_deque<int> dq;
+		dq.reserve(100);
+		dq.push_back(1);
+		dq.push_front(0);
+		dq.shrink_to_fit();
+		REQUIRE_EQ(dq.capacity(), 2);
+		REQUIRE_EQ(to_vector(dq), std::vector<int>{0, 1});
+
+		dq.clear();
+		dq.shrink_to_fit();
+		REQUIRE_EQ(dq.capacity(), 0);
+	}
+
+	TEST_CASE("resize") {
+		vec_deque<int> dq{1, 2, 3};
+		dq.resize(5);
+		REQUIRE_EQ(to_vector(dq), std::vector<int>{1, 2, 3, 0, 0});
+		dq.resize(1);
+		REQUIRE_EQ(to_vector(dq), std::vector<int>{1});
+	}
+
+	TEST_CASE("copy and move") {
+		vec_deque<std::string> dq;
+		dq.push_back("b");
+		dq.push_front("a");
+
+		vec_deque<std::string> cpy{dq};
+		REQUIRE_EQ(cpy, dq);
+
+		vec_deque<std::string> mv{std::move(cpy)};
+		REQUIRE_EQ(mv, dq);
+		REQUIRE(cpy.empty());
+
+		vec_deque<std::string> cpy_assign;
+		cpy_assign = dq;
+		REQUIRE_EQ(cpy_assign, dq);
+
+		vec_deque<std::string> mv_assign{"x"};
+		mv_assign = std::move(cpy_assign);
+		REQUIRE_EQ(mv_assign, dq);
+
+		swap(mv_assign, cpy_assign);
+		REQUIRE(mv_assign.empty());
+		REQUIRE_EQ(cpy_assign, dq);
+	}
+
+	TEST_CASE("comparison") {
+		vec_deque<int> const a{1, 2, 3};
+		vec_deque<int> const b{1, 2, 4};
+		REQUIRE_NE(a, b);
+		REQUIRE_LT(a, b);
+	}
+
+	TEST_CASE("iterators") {
+		vec_deque<int> dq{2, 3};
+		dq.push_front(1);
+
+		REQUIRE_EQ(dq.end() - dq.begin(), 3);
+		REQUIRE_EQ(*(dq.begin() + 2), 3);
+		REQUIRE_EQ(dq.begin()[1], 2);
+		REQUIRE_EQ(std::vector<int>(dq.rbegin(), dq.rend()), std::vector<int>{3, 2, 1});
+
+		for (auto &x : dq) {
+			x *= 10;
+		}
+		REQUIRE_EQ(to_vector(dq), std::vector<int>{10, 20, 30});
+	}
+
+	TEST_CASE("elements are destroyed") {
+		auto const value = std::make_shared<int>(1);
+		{
+			vec_deque<std::shared_ptr<int>> dq;
+			dq.push_back(value);
+			dq.push_front(value);
+			dq.push_back(value);
+			dq.pop_front();
+			REQUIRE_EQ(value.use_count(), 3);
+		}
+		REQUIRE_EQ(value.use_count(), 1);
+	}
+}